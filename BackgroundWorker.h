@@ -0,0 +1,131 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Background Worker
+
+Runs a function on a thread of its own until it's told to stop. Used for the threads that run as long as the game
+(the metrics and swap trace writers, the config watcher), so they all stop the same way.
+
+The function loops over its work and waits through Token::Sleep() in between, which returns false once Stop() was
+called. A writer that drains a queue should drain it once more after that: the flag is read before the drain, so
+everything queued before Stop() is still written.
+
+Stop() waits for the thread to end, so nothing the function uses is touched after it returned. Call it on game shutdown
+and never from the function itself. The destructor can't do the same: destructors of globals run while the DLL is being
+unloaded, and joining a thread under the loader lock can dead lock. A worker that is still running then is only told to
+stop and its thread ends on its own, so the function must own what it uses (ie. capture a std::shared_ptr by value)
+instead of pointing into the object that started it.
+
+*/// ----------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+
+// ------------------------------------------------------
+
+class BackgroundWorker
+{
+public:
+
+	static constexpr unsigned int
+				STOP_CHECK_INTERVAL = 50; // ms, Stop() waits about this long for a sleeping function
+
+	// Handed to the function, tells it when to stop
+	class Token
+	{
+	private:
+
+		std::shared_ptr<std::atomic<bool>>
+					m_pStop;
+
+	public:
+
+		Token(std::shared_ptr<std::atomic<bool>> pStop) :
+			m_pStop(std::move(pStop))
+		{
+
+		}
+
+		bool IsStopping() const
+		{
+			return *m_pStop;
+		}
+
+		// Sleeps in steps of STOP_CHECK_INTERVAL and returns early once Stop() was called.
+		// Returns false if Stop() was called.
+		bool Sleep(unsigned int iMilliseconds) const
+		{
+			for (unsigned int iSlept = 0; iSlept < iMilliseconds && !*m_pStop; iSlept += STOP_CHECK_INTERVAL)
+				std::this_thread::sleep_for(std::chrono::milliseconds(std::min(STOP_CHECK_INTERVAL, iMilliseconds - iSlept)));
+
+			return !*m_pStop;
+		}
+	};
+
+private:
+
+	std::shared_ptr<std::atomic<bool>>
+				m_pStop; // Shared with the thread, so it stays valid if the thread outlives the worker
+
+	std::thread	m_Thread;
+
+public:
+
+	BackgroundWorker()
+	{
+
+	}
+
+	~BackgroundWorker()
+	{
+		if (!m_pStop)
+			return;
+
+		*m_pStop = true;
+
+		if (m_Thread.joinable())
+			m_Thread.detach();
+	}
+
+	BackgroundWorker(const BackgroundWorker&) = delete;
+	BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+	// Stops the running function, if any, and runs fnRun on a new thread.
+	void Start(std::function<void(const Token&)> fnRun)
+	{
+		Stop();
+
+		m_pStop = std::make_shared<std::atomic<bool>>(false);
+
+		m_Thread = std::thread([StopToken = Token(m_pStop), fnRun = std::move(fnRun)]()
+		{
+			fnRun(StopToken);
+		});
+	}
+
+	// Waits for the thread to end, at most about STOP_CHECK_INTERVAL plus whatever the function is busy with.
+	void Stop()
+	{
+		if (!m_pStop)
+			return;
+
+		*m_pStop = true;
+
+		if (m_Thread.joinable())
+			m_Thread.join();
+
+		m_pStop.reset();
+	}
+
+	bool IsRunning() const
+	{
+		return m_pStop != nullptr;
+	}
+};
+
+// ------------------------------------------------------
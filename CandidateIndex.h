@@ -0,0 +1,268 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Candidate Index
+
+Finds the active entities (ie. driven vehicles, peds on foot) near the player over all entity pools (vehicles, peds
+and objects). Every entry is tagged with its entity type (see MakeEntityId()), so a single query around the player
+finds candidates of every type instead of scanning each pool separately.
+
+Each pool has its own PoolTracker, so only active entities are looked at. Types that aren't needed in a tick are left
+out of the update completely.
+
+The update is incremental over time: an entity that is farther than the query radius can't get into it before it and
+the player covered the distance in between, moving at MAX_SPEED at most. It isn't looked at again until then, so
+most ticks only read the entities that are close to the player. If the player moves faster than that (ie. is
+teleported), every entity is looked at again.
+
+The entities within the radius are stored as structure of arrays, a query is one FilterByDistance() over them.
+tools/CandidateBench.cpp compares this with scanning the whole pool.
+
+Usage:
+
+- Forward creation/destruction of each type to OnCreated()/OnDestroyed().
+- Call Update() once per tick with the types to index and the area that will be queried.
+- Call Query() as often as needed until the next Update(), within the area passed to Update().
+
+*/// ----------------------------------------------------
+
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+#include "World.h"
+#include "DistanceFilter.h"
+#include "PoolTracker.h"
+
+// ------------------------------------------------------
+
+namespace EntityType
+{
+	enum
+	{
+		VEHICLE = 0,
+		PED,
+		OBJECT,
+
+		COUNT
+	};
+
+	constexpr unsigned int Bit(int iType)
+	{
+		return 1U << iType;
+	}
+}
+
+// Entity IDs hold the type in the top bits and the pool index in the lower 24 bits. -1 is none.
+
+inline int MakeEntityId(int iType, int iIndex)
+{
+	return (iType << 24) | iIndex;
+}
+
+inline int GetEntityType(int iEntity)
+{
+	return iEntity >> 24;
+}
+
+inline int GetEntityIndex(int iEntity)
+{
+	return iEntity & 0xFFFFFF;
+}
+
+// ------------------------------------------------------
+
+class CandidateIndex
+{
+public:
+
+	static constexpr float
+				MAX_SPEED = 0.15f; // Units per ms any entity is assumed to move at most, 540 km/h
+
+	static constexpr unsigned int
+				MAX_SLEEP = 1000; // ms an entity is skipped at most
+
+private:
+
+	PoolTracker	m_aTrackers[EntityType::COUNT];
+
+	std::vector<unsigned int>
+				m_avWakeTime[EntityType::COUNT]; // Per pool index, the entity is skipped until this time
+
+	// Entities within the radius of the last update
+
+	std::vector<int>
+				m_vEntity;
+
+	std::vector<float>
+				m_vX,
+				m_vY,
+				m_vZ;
+
+	size_t		m_iCount = 0; // Used entries of the arrays above
+
+	SVector3	m_vecCenter;
+	float		m_fRadius = 0.0f;
+
+	unsigned int
+				m_iLastUpdate = 0;
+
+	bool		m_bUpdated = false;
+
+	void _Wake(int iType, int iIndex)
+	{
+		if ((size_t)iIndex >= m_avWakeTime[iType].size())
+			m_avWakeTime[iType].resize((size_t)iIndex + 1, m_iLastUpdate);
+
+		m_avWakeTime[iType][iIndex] = m_iLastUpdate;
+	}
+
+public:
+
+	void OnCreated(int iType, int iIndex)
+	{
+		if (iIndex < 0)
+			return;
+
+		m_aTrackers[iType].OnCreated(iIndex);
+		_Wake(iType, iIndex);
+	}
+
+	void OnDestroyed(int iType, int iIndex)
+	{
+		if (iIndex < 0)
+			return;
+
+		m_aTrackers[iType].OnDestroyed(iIndex);
+		_Wake(iType, iIndex);
+	}
+
+	// The active list of a tracker still holds skipped entities, even if they aren't active anymore.
+	const PoolTracker& GetTracker(int iType) const
+	{
+		return m_aTrackers[iType];
+	}
+
+	// Handle of an entity ID, see PoolTracker::GetHandle().
+	SSlotHandle GetHandle(int iEntity) const
+	{
+		return m_aTrackers[GetEntityType(iEntity)].GetHandle(GetEntityIndex(iEntity));
+	}
+
+	// iTypeMask: EntityType::Bit() of each type to index, the others are left out until the next update.
+	// fnIsActive: bool(int iEntity), see PoolTracker::Update().
+	// fnGetPosition: SVector3(int iEntity).
+	// vecCenter, fRadius: Area the following queries are in, usually around the player.
+	// iNow: Time in ms, may wrap around.
+	// Returns the amount of entities that were looked at.
+	template<typename F, typename G>
+	size_t Update(unsigned int iTypeMask, F fnIsActive, G fnGetPosition, const SVector3& vecCenter, float fRadius, unsigned int iNow,
+		unsigned int iRefreshTicks = 8)
+	{
+		size_t
+			iChecked = 0,
+			iMaxCount = 0;
+
+		float
+			fRadiusSq = fRadius * fRadius,
+			fMaxMove = MAX_SPEED * (float)(iNow - m_iLastUpdate);
+
+		// Teleported (or the first update), the skipped entities may be anywhere relative to the player now.
+		// A bigger radius may include some of them as well.
+
+		if (!m_bUpdated || (vecCenter - m_vecCenter).MagnitudeSqr() > fMaxMove * fMaxMove || fRadius > m_fRadius)
+		{
+			for (auto &vWakeTime : m_avWakeTime)
+				for (auto &iWakeTime : vWakeTime)
+					iWakeTime = iNow;
+		}
+
+		m_vecCenter = vecCenter;
+		m_fRadius = fRadius;
+		m_iLastUpdate = iNow;
+		m_bUpdated = true;
+
+		// Sized for every entity that can be active after the update, so adding one is a plain store
+
+		for (int iType = 0; iType < EntityType::COUNT; ++iType)
+			if (iTypeMask & EntityType::Bit(iType))
+				iMaxCount += m_aTrackers[iType].GetActive().size() + m_aTrackers[iType].GetLive().size() / (iRefreshTicks ? iRefreshTicks : 1) + 1;
+
+		if (m_vEntity.size() < iMaxCount)
+		{
+			m_vEntity.resize(iMaxCount);
+			m_vX.resize(iMaxCount);
+			m_vY.resize(iMaxCount);
+			m_vZ.resize(iMaxCount);
+		}
+
+		m_iCount = 0;
+
+		for (int iType = 0; iType < EntityType::COUNT; ++iType)
+		{
+			if (!(iTypeMask & EntityType::Bit(iType)))
+				continue;
+
+			// Skipped entities are kept as they are, whether they are still active is checked once they are looked at again
+
+			m_aTrackers[iType].Update([&](int i)
+			{
+				int
+					iEntity = MakeEntityId(iType, i);
+
+				unsigned int
+					&iWakeTime = m_avWakeTime[iType][i];
+
+				SVector3
+					vecPos;
+
+				float
+					fDistSq;
+
+				if ((int)(iWakeTime - iNow) > 0)
+					return true;
+
+				++iChecked;
+
+				if (!fnIsActive(iEntity))
+					return false;
+
+				vecPos = fnGetPosition(iEntity);
+				fDistSq = (vecPos - vecCenter).MagnitudeSqr();
+
+				if (fDistSq > fRadiusSq)
+				{
+					// Both the entity and the player may move towards each other
+
+					iWakeTime = iNow + (unsigned int)std::min((sqrtf(fDistSq) - fRadius) / (2.0f * MAX_SPEED), (float)MAX_SLEEP);
+					return true;
+				}
+
+				m_vEntity[m_iCount] = iEntity;
+				m_vX[m_iCount] = vecPos.x;
+				m_vY[m_iCount] = vecPos.y;
+				m_vZ[m_iCount] = vecPos.z;
+				++m_iCount;
+
+				return true;
+			}, iRefreshTicks);
+		}
+
+		return iChecked;
+	}
+
+	// Appends the entity ID of every indexed entity within fRadius of vecPos to vResult.
+	// The area must be within the one passed to the last Update().
+	size_t Query(const SVector3& vecPos, float fRadius, std::vector<int>& vResult) const
+	{
+		if (!m_iCount)
+			return 0;
+
+		return FilterByDistance(m_vX.data(), m_vY.data(), m_vZ.data(), m_vEntity.data(), m_iCount,
+			vecPos.x, vecPos.y, vecPos.z, fRadius * fRadius, vResult);
+	}
+};
+
+// ------------------------------------------------------
@@ -0,0 +1,89 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Collision Predictor
+
+Predicts when an entity is going to hit the player by sweeping bounding spheres along their velocities.
+
+Usage:
+
+- Call Begin() once per tick with the time span to look ahead (ie. the time step of the current frame).
+- Call AddCandidate() for every nearby entity with its position and velocity relative to the player, it returns the
+  time until the entity touches the player within that time span, or -1.
+
+Times are in the same unit as the velocities, for GTA that's the game's time step (1.0 = 1/50 s).
+Entities that already overlap only count if they are still moving towards each other, so traffic driving side by side
+doesn't trigger anything.
+
+*/// ----------------------------------------------------
+
+#include <math.h>
+
+// ------------------------------------------------------
+
+// Returns the time until two spheres with the given combined radius touch, 0 if they overlap and are closing in,
+// or -1 if they never touch.
+inline float SweptSphereTimeToContact(float fRelX, float fRelY, float fRelZ, float fRelVX, float fRelVY, float fRelVZ, float fRadius)
+{
+	float
+		fA = fRelVX * fRelVX + fRelVY * fRelVY + fRelVZ * fRelVZ,
+		fB = fRelX * fRelVX + fRelY * fRelVY + fRelZ * fRelVZ, // Half of the actual b, saves a few multiplications
+		fC = fRelX * fRelX + fRelY * fRelY + fRelZ * fRelZ - fRadius * fRadius,
+		fDisc;
+
+	// Moving apart (or not moving at all)
+
+	if (fB >= 0.0f || fA <= 0.0f)
+		return -1.0f;
+
+	if (fC <= 0.0f)
+		return 0.0f;
+
+	fDisc = fB * fB - fA * fC;
+
+	if (fDisc < 0.0f)
+		return -1.0f;
+
+	return (-fB - sqrtf(fDisc)) / fA;
+}
+
+// ------------------------------------------------------
+
+class CollisionPredictor
+{
+private:
+
+	float		m_fRadiusScale = 1.0f;
+	float		m_fHorizon = 1.0f;
+
+public:
+
+	// Bounding spheres are usually a lot bigger than the actual vehicle, scale them down to avoid false positives.
+	void SetRadiusScale(float fRadiusScale)
+	{
+		m_fRadiusScale = fRadiusScale;
+	}
+
+	void Begin(float fHorizon)
+	{
+		m_fHorizon = fHorizon;
+	}
+
+	// fRelX/Y/Z: Position of the candidate relative to the player.
+	// fRelVX/VY/VZ: Velocity of the candidate relative to the player.
+	// fRadius1/2: Bounding radius of the player and the candidate.
+	// Returns the time to contact or -1 if they won't touch within the horizon.
+	float AddCandidate(float fRelX, float fRelY, float fRelZ, float fRelVX, float fRelVY, float fRelVZ, float fRadius1, float fRadius2)
+	{
+		float
+			fTime = SweptSphereTimeToContact(fRelX, fRelY, fRelZ, fRelVX, fRelVY, fRelVZ, (fRadius1 + fRadius2) * m_fRadiusScale);
+
+		if (fTime < 0.0f || fTime > m_fHorizon)
+			return -1.0f;
+
+		return fTime;
+	}
+};
+
+// ------------------------------------------------------
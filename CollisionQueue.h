@@ -0,0 +1,155 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Collision Queue
+
+Collects every contact involving the player during a tick and picks one swap target from them, so a pile-up
+is resolved in a single tick instead of one contact per SwapDelay.
+
+Contacts come from different sources (see CollisionSource::), an entity reported by several of them is only kept
+once, with the source that comes first. Select() filters the contacts and picks the best one according to the
+target policy in a single pass. The choice is deterministic, ties go to the lower index.
+
+Usage:
+
+- Call Clear() once per tick, Add() for each contact.
+- Call Select() with the policy and a filter.
+
+*/// ----------------------------------------------------
+
+#include <stddef.h>
+#include <vector>
+
+// ------------------------------------------------------
+
+namespace CollisionSource
+{
+	enum
+	{
+		REPORTED = 0, // The game reported a collision for the player
+		REPORTED_BY_OTHER, // The game reported a collision with the player for the other entity
+		PREDICTED, // Predicted to touch during this frame, see CollisionPredictor.h
+	};
+}
+
+namespace TargetPolicy
+{
+	enum
+	{
+		FIRST = 0, // Reported before predicted, earlier predicted contacts first
+		CLOSING_SPEED, // Highest speed towards the player
+		HEALTHIEST,
+
+		MAX
+	};
+}
+
+// ------------------------------------------------------
+
+class CollisionQueue
+{
+public:
+
+	struct SContact
+	{
+		int			iIndex; // Pool index or entity ID, see CandidateIndex.h
+		int			iSource;
+
+		float		fContactTime; // 0 for reported contacts
+		float		fClosingSpeed; // Positive if moving towards the player
+		float		fHealth;
+	};
+
+private:
+
+	std::vector<SContact>
+				m_vContacts;
+
+	// True if a should be picked over b
+	static bool _IsBetter(const SContact& a, const SContact& b, int iPolicy)
+	{
+		switch (iPolicy)
+		{
+		case TargetPolicy::CLOSING_SPEED:
+			if (a.fClosingSpeed != b.fClosingSpeed)
+				return a.fClosingSpeed > b.fClosingSpeed;
+			break;
+
+		case TargetPolicy::HEALTHIEST:
+			if (a.fHealth != b.fHealth)
+				return a.fHealth > b.fHealth;
+			break;
+
+		default:
+			if (a.iSource != b.iSource)
+				return a.iSource < b.iSource;
+
+			if (a.fContactTime != b.fContactTime)
+				return a.fContactTime < b.fContactTime;
+			break;
+		}
+
+		return a.iIndex < b.iIndex;
+	}
+
+public:
+
+	void Clear()
+	{
+		m_vContacts.clear();
+	}
+
+	void Add(const SContact& Contact)
+	{
+		if (Contact.iIndex < 0)
+			return;
+
+		// There are only a few contacts per tick, a linear search is fastest
+
+		for (auto &Existing : m_vContacts)
+		{
+			if (Existing.iIndex != Contact.iIndex)
+				continue;
+
+			if (Contact.iSource < Existing.iSource)
+				Existing = Contact;
+
+			return;
+		}
+
+		m_vContacts.push_back(Contact);
+	}
+
+	// fnIsAllowed: bool(const SContact&), called once for every contact in the order they were added.
+	// Returns the index of the best allowed contact or -1.
+	template<typename F>
+	int Select(int iPolicy, F fnIsAllowed) const
+	{
+		const SContact
+			*pBest = nullptr;
+
+		for (auto &Contact : m_vContacts)
+		{
+			if (!fnIsAllowed(Contact))
+				continue;
+
+			if (!pBest || _IsBetter(Contact, *pBest, iPolicy))
+				pBest = &Contact;
+		}
+
+		return pBest ? pBest->iIndex : -1;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_vContacts.empty();
+	}
+
+	size_t GetCount() const
+	{
+		return m_vContacts.size();
+	}
+};
+
+// ------------------------------------------------------
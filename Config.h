@@ -0,0 +1,52 @@
+#pragma once
+
+// ------------------------------------------------------
+
+constexpr unsigned int MODEL_LIST_SIZE = 128; // Max entries of the model lists
+
+struct SConfig
+{
+    bool bLoaded = false;
+
+    bool bActive = true;
+
+    bool bActiveOnMission = false;
+    bool bActiveOnSubmission = false;
+    
+    unsigned int iSwapDelay = 100;
+    unsigned int iSwapBackDelay = 1500;
+
+    bool bHotReload = false; // Reload the config when one of the files changes
+    unsigned int iHotReloadInterval = 1000; // ms between checks
+
+    bool bPredictiveSwap = false;
+    float fPredictRadiusScale = 0.75f;
+
+    int iTargetPolicy = 0; // Which of several contacts to swap to, 0 = first reported, 1 = highest closing speed, 2 = healthiest
+
+    int aAllowedModels[MODEL_LIST_SIZE] = {}; // Only swap into these models, all if empty
+    int aBlockedModels[MODEL_LIST_SIZE] = {}; // Never swap into these models
+    bool bSwapToMissionVehicles = false; // Vehicles created by mission scripts
+    bool bSwapToMissionPeds = false; // Peds created by mission scripts
+
+    // Swaps the player can do, from what they control (on foot = ped) to what they collide with.
+    // Only vehicle to vehicle is enabled by default, swaps from and to objects are not supported yet.
+
+    bool bPedToPed = false;
+    bool bPedToVehicle = false;
+    bool bPedToObject = false;
+
+    bool bVehicleToPed = false;
+    bool bVehicleToVehicle = true;
+    bool bVehicleToObject = false;
+
+    bool bObjectToPed = false;
+    bool bObjectToVehicle = false;
+    bool bObjectToObject = false;
+
+    unsigned int iMaxPhysicsVehicles = 32; // 0 = no limit
+    float fPhysicsRadius = 40.0f;
+    float fPhysicsDemoteRadius = 60.0f;
+};
+
+// ------------------------------------------------------
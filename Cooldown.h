@@ -0,0 +1,71 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Cooldown Table
+
+Per pool slot cooldowns, ie. to not swap back into a vehicle the player just left. Starting and checking a cooldown
+is a single array access.
+
+Entries are keyed by a slot handle (see PoolTracker.h). A cooldown only applies to the entity it was started for,
+once that entity is destroyed its handle no longer matches and the cooldown is ignored, even if the slot is used
+again. Nothing has to be cleaned up when entities are destroyed.
+
+*/// ----------------------------------------------------
+
+#include <vector>
+
+#include "PoolTracker.h"
+
+// ------------------------------------------------------
+
+class CooldownTable
+{
+private:
+
+	struct SEntry
+	{
+		bool		bStarted = false;
+
+		unsigned int
+					iGeneration = 0,
+					iStart = 0;
+	};
+
+	std::vector<SEntry>
+				m_vEntries;
+
+public:
+
+	void Start(const SSlotHandle& Handle, unsigned int iNow)
+	{
+		if (Handle.iIndex < 0)
+			return;
+
+		if ((size_t)Handle.iIndex >= m_vEntries.size())
+			m_vEntries.resize((size_t)Handle.iIndex + 1);
+
+		m_vEntries[Handle.iIndex].bStarted = true;
+		m_vEntries[Handle.iIndex].iGeneration = Handle.iGeneration;
+		m_vEntries[Handle.iIndex].iStart = iNow;
+	}
+
+	// True if a cooldown was started for this entity less than iDuration ms ago.
+	bool IsActive(const SSlotHandle& Handle, unsigned int iNow, unsigned int iDuration) const
+	{
+		if (Handle.iIndex < 0 || (size_t)Handle.iIndex >= m_vEntries.size())
+			return false;
+
+		const SEntry
+			&Entry = m_vEntries[Handle.iIndex];
+
+		return Entry.bStarted && Entry.iGeneration == Handle.iGeneration && iNow - Entry.iStart < iDuration;
+	}
+
+	void Clear()
+	{
+		m_vEntries.clear();
+	}
+};
+
+// ------------------------------------------------------
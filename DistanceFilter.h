@@ -0,0 +1,147 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Distance Filter
+
+Finds all positions within a radius of a point. Positions are passed as structure of arrays
+(one array per axis) so they can be compared several at a time.
+
+Uses AVX2 or SSE2 depending on what the compiler targets and falls back to plain C++ otherwise.
+Define DNC_NO_SIMD to always use the scalar version.
+
+*/// ----------------------------------------------------
+
+#include <stddef.h>
+#include <vector>
+
+#if !defined DNC_NO_SIMD
+#if defined __AVX2__
+#define DNC_SIMD_AVX2
+#include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define DNC_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+// ------------------------------------------------------
+
+// Which version FilterByDistance() uses, ie. for benchmarks.
+inline const char* GetDistanceFilterVersion()
+{
+#if defined DNC_SIMD_AVX2
+	return "AVX2";
+#elif defined DNC_SIMD_SSE2
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+// ------------------------------------------------------
+
+// Scalar version, also used for the remainder of the SIMD versions.
+inline size_t FilterByDistanceScalar(const float* pX, const float* pY, const float* pZ, const int* pIndex, size_t iCount,
+	float fX, float fY, float fZ, float fRadiusSq, std::vector<int>& vResult)
+{
+	size_t
+		iOldSize = vResult.size();
+
+	float
+		fDX,
+		fDY,
+		fDZ;
+
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		fDX = pX[i] - fX;
+		fDY = pY[i] - fY;
+		fDZ = pZ[i] - fZ;
+
+		if (fDX * fDX + fDY * fDY + fDZ * fDZ <= fRadiusSq)
+			vResult.push_back(pIndex[i]);
+	}
+
+	return vResult.size() - iOldSize;
+}
+
+// Appends pIndex[i] to vResult for every position i that is within sqrt(fRadiusSq) of (fX, fY, fZ).
+// The order of vResult is the same as the input order.
+// Returns the amount of indexes added.
+inline size_t FilterByDistance(const float* pX, const float* pY, const float* pZ, const int* pIndex, size_t iCount,
+	float fX, float fY, float fZ, float fRadiusSq, std::vector<int>& vResult)
+{
+	size_t
+		i = 0,
+		iOldSize = vResult.size();
+
+	unsigned int
+		iMask;
+
+#if defined DNC_SIMD_AVX2
+
+	__m256
+		vecX = _mm256_set1_ps(fX),
+		vecY = _mm256_set1_ps(fY),
+		vecZ = _mm256_set1_ps(fZ),
+		vecRadiusSq = _mm256_set1_ps(fRadiusSq),
+		vecDX,
+		vecDY,
+		vecDZ,
+		vecDistSq;
+
+	for (; i + 8 <= iCount; i += 8)
+	{
+		vecDX = _mm256_sub_ps(_mm256_loadu_ps(pX + i), vecX);
+		vecDY = _mm256_sub_ps(_mm256_loadu_ps(pY + i), vecY);
+		vecDZ = _mm256_sub_ps(_mm256_loadu_ps(pZ + i), vecZ);
+
+		vecDistSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vecDX, vecDX), _mm256_mul_ps(vecDY, vecDY)), _mm256_mul_ps(vecDZ, vecDZ));
+
+		iMask = (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(vecDistSq, vecRadiusSq, _CMP_LE_OQ));
+
+		for (size_t j = 0; iMask; ++j, iMask >>= 1)
+			if (iMask & 1)
+				vResult.push_back(pIndex[i + j]);
+	}
+
+#elif defined DNC_SIMD_SSE2
+
+	__m128
+		vecX = _mm_set1_ps(fX),
+		vecY = _mm_set1_ps(fY),
+		vecZ = _mm_set1_ps(fZ),
+		vecRadiusSq = _mm_set1_ps(fRadiusSq),
+		vecDX,
+		vecDY,
+		vecDZ,
+		vecDistSq;
+
+	for (; i + 4 <= iCount; i += 4)
+	{
+		vecDX = _mm_sub_ps(_mm_loadu_ps(pX + i), vecX);
+		vecDY = _mm_sub_ps(_mm_loadu_ps(pY + i), vecY);
+		vecDZ = _mm_sub_ps(_mm_loadu_ps(pZ + i), vecZ);
+
+		vecDistSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vecDX, vecDX), _mm_mul_ps(vecDY, vecDY)), _mm_mul_ps(vecDZ, vecDZ));
+
+		iMask = (unsigned int)_mm_movemask_ps(_mm_cmple_ps(vecDistSq, vecRadiusSq));
+
+		for (size_t j = 0; iMask; ++j, iMask >>= 1)
+			if (iMask & 1)
+				vResult.push_back(pIndex[i + j]);
+	}
+
+#else
+
+	(void)iMask;
+
+#endif
+
+	FilterByDistanceScalar(pX + i, pY + i, pZ + i, pIndex + i, iCount - i, fX, fY, fZ, fRadiusSq, vResult);
+
+	return vResult.size() - iOldSize;
+}
+
+// ------------------------------------------------------
@@ -12,20 +12,17 @@
 */
 // --------------------------------------------------------- 
 
-#include "plugin.h"
-#include <CEntity.h>
-#include <CPlayerPed.h>
-#include <CVehicle.h>
-#include <CCamera.h>
-#include <CPools.h>
-#include <CTheScripts.h>
-#include <extensions/ScriptCommands.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 #include "StructParser.h"
-
-#if defined GTAVC && !defined eEntityStatus // Missing in CEntity.h for older plugin SDK versions
-#include <eEntityStatus.h>
-#endif
+#include "Config.h"
+#include "GameWorld.h"
+#include "SwapEngine.h"
+#include "FileWatcher.h"
+#include "Snapshot.h"
+#include "StructCache.h"
 
 #if defined GTASA
 #include "SAMP.h"
@@ -41,267 +38,276 @@
 #define GTA_GAME_NAME "SA"
 #endif
 
-#if defined GTAVC && !defined eEntityType
-enum PLUGIN_API eEntityType // Missing in VC for older plugin SDK versions
-{
-    ENTITY_TYPE_NOTHING = 0,
-    ENTITY_TYPE_BUILDING = 1,
-    ENTITY_TYPE_VEHICLE = 2,
-    ENTITY_TYPE_PED = 3,
-    ENTITY_TYPE_OBJECT = 4
-};
-#endif
-
 using namespace plugin;
 
-struct SConfig
-{
-    bool bLoaded = false;
-
-    bool bActive = true;
+SConfig g_Config;
 
-    bool bActiveOnMission = false;
-    bool bActiveOnSubmission = false;
-    
-    unsigned int iSwapDelay = 100;
-    unsigned int iSwapBackDelay = 1500;
+SnapshotExchange<SConfig> g_PendingConfig; // Config loaded on another thread, picked up by the next tick
+FileWatcher g_ConfigWatcher;
 
-    bool bPedToPed = true;
-    bool bPedToVehicle = true;
-    bool bPedToObject = true;
+std::atomic<long long> g_iConfigLoadTime { -1 }; // Microseconds the initial load took, -1 until it's done
 
-    bool bVehicleToPed = true;
-    bool bVehicleToVehicle = true;
-    bool bVehicleToObject = true;
+// The global config first, then the first per-game config that exists
 
-    bool bObjectToPed = true;
-    bool bObjectToVehicle = true;
-    bool bObjectToObject = true;
+const char* const g_aszConfigFiles[] =
+{
+    "../GTA DoNotCrash/DoNotCrash.Global.ini",
+    "scripts/DoNotCrash." GTA_GAME_NAME ".ini",              // scripts/
+    "plugins/DoNotCrash." GTA_GAME_NAME ".ini",              // plugins/
+    "DoNotCrash." GTA_GAME_NAME ".ini"                       // root dir
 };
 
-SConfig g_Config;
+constexpr size_t CONFIG_FILE_COUNT = sizeof(g_aszConfigFiles) / sizeof(g_aszConfigFiles[0]);
 
-void LoadConfig()
-{
-    SConfig
-        Base;
+// Merged result of all config files, used as long as none of them change
 
-    StructParser<SConfig>
-        *pStructParser = new StructParser<SConfig>(&Base);
+#define CONFIG_CACHE_FILE "DoNotCrash." GTA_GAME_NAME ".cache"
 
-#define VAR(x) &x, sizeof(x) // Only use it for non-arrays.
+GameWorld g_GameWorld;
+SwapEngine<GameWorld> g_SwapEngine(g_GameWorld);
 
-    // General
+// Types, sizes and offsets are taken from SConfig and the lookup table is built at compile time
 
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bActive), 1, "General", "Active");
+static constexpr auto g_ConfigSchema = MakeStructSchema<SConfig>({
+    // General
 
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bActiveOnMission), 1, "General", "ActiveOnMission");
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bActiveOnSubmission), 1, "General", "ActiveOnSubmission");
+    STRUCT_FIELD(SConfig, bActive, "General", "Active"),
 
-    pStructParser->Link(LinkType::UNSIGNED, VAR(Base.iSwapDelay), 1, "General", "SwapDelay");
-    pStructParser->Link(LinkType::UNSIGNED, VAR(Base.iSwapBackDelay), 1, "General", "SwapBackDelay");
+    STRUCT_FIELD(SConfig, bActiveOnMission, "General", "ActiveOnMission"),
+    STRUCT_FIELD(SConfig, bActiveOnSubmission, "General", "ActiveOnSubmission"),
 
-    // SwapTypes
+    STRUCT_FIELD(SConfig, iSwapDelay, "General", "SwapDelay"),
+    STRUCT_FIELD(SConfig, iSwapBackDelay, "General", "SwapBackDelay"),
 
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bPedToPed), 1, "SwapTypes", "PedToPed");
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bPedToVehicle), 1, "SwapTypes", "PedToVehicle");
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bPedToObject), 1, "SwapTypes", "PedToObject");
+    STRUCT_FIELD(SConfig, bHotReload, "General", "HotReload"),
+    STRUCT_FIELD(SConfig, iHotReloadInterval, "General", "HotReloadInterval"),
 
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bVehicleToPed), 1, "SwapTypes", "VehicleToPed");
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bVehicleToVehicle), 1, "SwapTypes", "VehicleToVehicle");
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bVehicleToObject), 1, "SwapTypes", "VehicleToObject");
+    STRUCT_FIELD(SConfig, bPredictiveSwap, "General", "PredictiveSwap"),
+    STRUCT_FIELD(SConfig, fPredictRadiusScale, "General", "PredictRadiusScale"),
 
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bObjectToPed), 1, "SwapTypes", "ObjectToPed");
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bObjectToVehicle), 1, "SwapTypes", "ObjectToVehicle");
-    pStructParser->Link(LinkType::BOOL, VAR(Base.bObjectToObject), 1, "SwapTypes", "ObjectToObject");
+    STRUCT_FIELD(SConfig, iTargetPolicy, "General", "TargetPolicy"),
 
-#undef VAR
+    // Filter
 
-    // First check if there is an ini for all games and load it
+    STRUCT_FIELD(SConfig, aAllowedModels, "Filter", "AllowedModels"),
+    STRUCT_FIELD(SConfig, aBlockedModels, "Filter", "BlockedModels"),
+    STRUCT_FIELD(SConfig, bSwapToMissionVehicles, "Filter", "MissionVehicles"),
+    STRUCT_FIELD(SConfig, bSwapToMissionPeds, "Filter", "MissionPeds"),
 
-    if (pStructParser->ParseFile("../GTA DoNotCrash/DoNotCrash.Global.ini", &g_Config) != -1)
-    {
-        g_Config.bLoaded = true;
-    }
+    // SwapTypes
 
-    // Next override the current config with any vales found in the game's directory
+    STRUCT_FIELD(SConfig, bPedToPed, "SwapTypes", "PedToPed"),
+    STRUCT_FIELD(SConfig, bPedToVehicle, "SwapTypes", "PedToVehicle"),
+    STRUCT_FIELD(SConfig, bPedToObject, "SwapTypes", "PedToObject"),
 
-    if (pStructParser->ParseFile("scripts/DoNotCrash." GTA_GAME_NAME ".ini", &g_Config) != -1 ||              // scripts/
-        pStructParser->ParseFile("plugins/DoNotCrash." GTA_GAME_NAME ".ini", &g_Config) != -1 ||              // plugins/
-        pStructParser->ParseFile("DoNotCrash." GTA_GAME_NAME ".ini", &g_Config) != -1                         // root dir
-        )
-    {
-        g_Config.bLoaded = true;
-    }
+    STRUCT_FIELD(SConfig, bVehicleToPed, "SwapTypes", "VehicleToPed"),
+    STRUCT_FIELD(SConfig, bVehicleToVehicle, "SwapTypes", "VehicleToVehicle"),
+    STRUCT_FIELD(SConfig, bVehicleToObject, "SwapTypes", "VehicleToObject"),
 
-    delete pStructParser;
-}
+    STRUCT_FIELD(SConfig, bObjectToPed, "SwapTypes", "ObjectToPed"),
+    STRUCT_FIELD(SConfig, bObjectToVehicle, "SwapTypes", "ObjectToVehicle"),
+    STRUCT_FIELD(SConfig, bObjectToObject, "SwapTypes", "ObjectToObject"),
 
-class DoNotCrash {
-public:
-    DoNotCrash()
-    {
-#if defined GTASA
-        if (IsSAMP())
-            return;
-#endif
+    // Physics
 
-        // Add to scripts event
+    STRUCT_FIELD(SConfig, iMaxPhysicsVehicles, "Physics", "MaxVehicles"),
+    STRUCT_FIELD(SConfig, fPhysicsRadius, "Physics", "Radius"),
+    STRUCT_FIELD(SConfig, fPhysicsDemoteRadius, "Physics", "DemoteRadius")
+});
 
-        Events::processScriptsEvent += []
-        {
-            CPlayerPed
-                *pPlayerPed;
+// The startup load maps the files (see StructParser::ParseFile()). A reload follows an edit that may still be going on,
+// and a mapped file that is truncated meanwhile crashes the reader on POSIX (SIGBUS) or makes the editor's save fail on
+// Windows. So reloads stream the file through a small buffer instead.
+int ParseConfigFile(StructParser<SConfig>& Parser, const char* szFileName, StructDocument<SConfig>& Document, bool bReload)
+{
+    if (!bReload)
+        return Parser.ParseFile(szFileName, Document);
 
-            CVehicle
-                *pPlayerVehicle;
+    StructStream<SConfig>
+        Stream(Parser, Document);
 
-            CPed
-                *pTargetPed;
+    return Stream.FeedFile(szFileName);
+}
 
-            CVehicle
-                *pTargetVehicle;
+// Loads all config files into Config. Doesn't touch any globals, so it can run on any thread.
+// bReload: The files changed since the game started, see ParseConfigFile().
+void LoadConfig(SConfig& Config, bool bReload)
+{
+    StructParser<SConfig>
+        Parser(g_ConfigSchema);
 
-            CVector
-                vecPlayerVelocity,
-                vecTargetVelocity;
+    StructDocument<SConfig>
+        Document;
 
-            static DWORD
-                dwLastSwap = GetTickCount();
+    std::vector<StructCache::SSource>
+        vSources;
 
-            DWORD
-                dwNow = GetTickCount();
+    // Skip parsing if none of the files changed since the cache was written
 
-            static CVehicle
-                *pLastVehicle = nullptr;
+    if (StructCache::Load(CONFIG_CACHE_FILE, g_aszConfigFiles, CONFIG_FILE_COUNT, g_ConfigSchema.GetHash(), &Config, vSources))
+        return;
 
-            static bool
-                bInit = false;
+    // All files are decoded into one document, values from later files override earlier ones
 
-            // Load config
+    // First check if there is an ini for all games and load it
 
-            if (!bInit)
-            {
-                LoadConfig();
-                bInit = true;
-            }
+    if (ParseConfigFile(Parser, g_aszConfigFiles[0], Document, bReload) != -1)
+    {
+        Config.bLoaded = true;
+    }
 
-            // Check if we even need to do anything
+    // Next override the current config with any vales found in the game's directory
 
-            if (!g_Config.bActive || 
-                dwNow - dwLastSwap < g_Config.iSwapDelay ||
-                !Command<Commands::IS_PLAYER_PLAYING>(0) ||
-                !g_Config.bActiveOnMission && CTheScripts::IsPlayerOnAMission()
-                )
-                return;
+    for (size_t i = 1; i < CONFIG_FILE_COUNT; ++i)
+    {
+        if (ParseConfigFile(Parser, g_aszConfigFiles[i], Document, bReload) != -1)
+        {
+            Config.bLoaded = true;
+            break;
+        }
+    }
 
-#if defined GTASA
+    Document.Apply(&Config);
 
-            if (!g_Config.bActiveOnSubmission && CTheScripts::bMiniGameInProgress)
-                return;
+    // The demote radius must include the promote radius, otherwise vehicles get promoted and demoted every tick
 
-#endif
+    if (Config.fPhysicsDemoteRadius < Config.fPhysicsRadius)
+        Config.fPhysicsDemoteRadius = Config.fPhysicsRadius;
 
-            // Find Player and Vehicle
+    // Shorter intervals would make the watcher poll the files non-stop
 
-#if defined GTASA
+    if (Config.iHotReloadInterval < FileWatcher::MIN_INTERVAL)
+        Config.iHotReloadInterval = FileWatcher::MIN_INTERVAL;
 
-            pPlayerPed = FindPlayerPed(0);
-            pPlayerVehicle = FindPlayerVehicle(0, false);
+    // Without any ini the defaults are all there is, a cache of them would only be one more file in the game's directory
 
-#else
+    if (Config.bLoaded)
+        StructCache::Save(CONFIG_CACHE_FILE, vSources, g_ConfigSchema.GetHash(), &Config);
+}
 
-            pPlayerPed = FindPlayerPed();
-            pPlayerVehicle = FindPlayerVehicle();
+// Initial load on a worker thread, the result is picked up by the ticks like a reload.
+void LoadConfigAsync()
+{
+    std::chrono::steady_clock::time_point
+        tStart = std::chrono::steady_clock::now();
 
-#endif
+    SConfig
+        *pConfig = new SConfig;
 
-            if (!pPlayerPed || !pPlayerVehicle || pPlayerVehicle->m_pDriver != pPlayerPed)
-                return;
+    LoadConfig(*pConfig, false);
 
-            // Make all vehicles be fully processed. Modern hardware can handle it!
+    g_iConfigLoadTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+    g_PendingConfig.Publish(pConfig);
+}
 
-            for (int i = 0; i < CPools::ms_pVehiclePool->m_nSize; ++i)
-            {
-                if (CPools::ms_pVehiclePool->IsFreeSlotAtIndex(i))
-                    continue;
+// Reloads the config off the game thread whenever one of the files changes. The setting itself is only read at startup.
+void StartConfigWatcher()
+{
+    g_ConfigWatcher.Start(std::vector<std::string>(std::begin(g_aszConfigFiles), std::end(g_aszConfigFiles)), g_Config.iHotReloadInterval, []
+    {
+        SConfig
+            *pConfig = new SConfig;
 
-                pTargetVehicle = CPools::ms_pVehiclePool->GetAt(i);
+        LoadConfig(*pConfig, true);
+        g_PendingConfig.Publish(pConfig);
+    });
+}
 
-                if (!pTargetVehicle->m_pDriver)
-                    continue;
+class DoNotCrash {
+public:
+    DoNotCrash()
+    {
+#if defined GTASA
+        if (IsSAMP())
+            return;
+#endif
 
-                if ((pTargetVehicle->GetPosition() - pPlayerVehicle->GetPosition()).Magnitude() > 40.0f)
-                    continue;
+        // Keep track of vehicles as they are created and destroyed
 
-#if defined GTASA
+        Events::vehicleCtorEvent += [](CVehicle* pVehicle)
+        {
+            g_SwapEngine.OnVehicleCreated(CPools::ms_pVehiclePool->GetIndex(pVehicle));
+        };
 
-                if (pTargetVehicle->m_nStatus == STATUS_SIMPLE)
-                    pTargetVehicle->m_nStatus = STATUS_PHYSICS;
+        Events::vehicleDtorEvent += [](CVehicle* pVehicle)
+        {
+            g_SwapEngine.OnVehicleDestroyed(CPools::ms_pVehiclePool->GetIndex(pVehicle));
+        };
 
-#else
+        // Same for peds, they can be swapped to as well (see SwapTypes)
 
-                if (pTargetVehicle->m_nState == STATUS_SIMPLE)
-                    pTargetVehicle->m_nState = STATUS_PHYSICS;
+        Events::pedCtorEvent += [](CPed* pPed)
+        {
+            g_SwapEngine.OnPedCreated(CPools::ms_pPedPool->GetIndex(pPed));
+        };
 
-#endif
-            }
+        Events::pedDtorEvent += [](CPed* pPed)
+        {
+            g_SwapEngine.OnPedDestroyed(CPools::ms_pPedPool->GetIndex(pPed));
+        };
 
-            // Find last collided vehicle and do the thing
-            
-#if defined GTAVC
+        // Start loading the config right away, so the game thread never waits for the files. A single load that ends
+        // on its own, so the thread isn't kept.
 
-            if (pPlayerVehicle->m_pPhysColliding != nullptr && pPlayerVehicle->m_pPhysColliding->m_nType == eEntityType::ENTITY_TYPE_VEHICLE)
-            {
-                pTargetVehicle = static_cast<CVehicle*>(pPlayerVehicle->m_pPhysColliding);
-                pTargetPed = pTargetVehicle->m_pDriver;
-            
+        std::thread(LoadConfigAsync).detach();
 
-#else
+        // Stop all background threads while the game still runs, see BackgroundWorker.h. The watcher publishes into
+        // g_PendingConfig and must not outlive it.
 
-            if (pPlayerVehicle->m_pDamageEntity != nullptr && pPlayerVehicle->m_pDamageEntity->m_nType == eEntityType::ENTITY_TYPE_VEHICLE)
-            {
-                pTargetVehicle = static_cast<CVehicle*>(pPlayerVehicle->m_pDamageEntity);
-                pTargetPed = pTargetVehicle->m_pDriver;
+        Events::shutdownRwEvent += []
+        {
+            g_ConfigWatcher.Stop();
+            g_SwapEngine.Shutdown();
+        };
 
-#endif
+        // Add to scripts event
 
-                if (pLastVehicle == pTargetVehicle && dwNow - dwLastSwap < g_Config.iSwapBackDelay || // Don't immediately jump back to the previous car
-                    pTargetVehicle->m_fHealth <= 250.0f // Don't swap into burning or exploded vehicles
-                    )
-                    return;
+        Events::processScriptsEvent += []
+        {
+            static bool
+                bInit = false,
+                bConfigLoaded = false;
 
-                pLastVehicle = pPlayerVehicle;
-                dwLastSwap = dwNow;
+            SConfig
+                *pConfig;
 
-                // Save velocity. When the vehicles are switched they usually lose all of it (requires status to be physics)
+            // Start with the defaults until the config is loaded
 
-                vecPlayerVelocity = pPlayerVehicle->m_vecMoveSpeed;
-                vecTargetVelocity = pTargetVehicle->m_vecMoveSpeed;
+            if (!bInit)
+            {
+                g_SwapEngine.SetConfig(g_Config);
+                g_SwapEngine.Init();
 
-                // Remove player from vehicle
+                bInit = true;
+            }
 
-                Command<Commands::WARP_CHAR_FROM_CAR_TO_COORD>(pPlayerPed, pPlayerPed->GetPosition().x, pPlayerPed->GetPosition().y, pPlayerPed->GetPosition().z + 15.0f);
+            // Pick up a config that was loaded in the background
 
-                if (pTargetPed) // If the target vehicle has a driver, remove the ped from vehicle and put them in the player vehicle
-                {
-                    Command<Commands::WARP_CHAR_FROM_CAR_TO_COORD>(pTargetPed, pTargetPed->GetPosition().x, pTargetPed->GetPosition().y, pTargetPed->GetPosition().z + 15.0f);
-                    Command<Commands::WARP_CHAR_INTO_CAR>(pTargetPed, pPlayerVehicle);
-                }
+            pConfig = g_PendingConfig.Take();
 
-                // Put player in target vehicle
+            if (pConfig)
+            {
+                g_Config = *pConfig;
+                delete pConfig;
 
-                Command<Commands::WARP_CHAR_INTO_CAR>(pPlayerPed, pTargetVehicle);
+                g_SwapEngine.SetConfig(g_Config);
 
-                // Restore camera
+                // The first one is the initial load, reloads only start after it
 
-                TheCamera.RestoreWithJumpCut();
+                if (!bConfigLoaded)
+                {
+                    if (g_Config.bHotReload)
+                        StartConfigWatcher();
 
-                // Restore velocity
+#if defined DNC_METRICS
+                    g_SwapEngine.GetMetrics().SetConfigLoadTime(g_iConfigLoadTime);
+#endif
 
-                pPlayerVehicle->m_vecMoveSpeed = vecPlayerVelocity;
-                pTargetVehicle->m_vecMoveSpeed = vecTargetVelocity;
+                    bConfigLoaded = true;
+                }
             }
+
+            g_SwapEngine.Process();
         }; // end processScriptsEvent
     }
 } doNotCrash;
@@ -0,0 +1,167 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+File Watcher
+
+Polls the size and last write time of a few files on a background thread and calls a function when any of them
+changed, was created or was deleted. Meant for config files, so polling about once per second is plenty.
+
+Stop() ends the thread and waits for it, so the function is never called after Stop() returned. Call it before the
+things the function uses are destroyed (ie. on game shutdown) and never from the function itself, see
+BackgroundWorker.h.
+
+*/// ----------------------------------------------------
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "BackgroundWorker.h"
+
+// ------------------------------------------------------
+
+struct SFileStamp
+{
+	bool		bExists = false;
+
+	unsigned long long
+				iSize = 0,
+				iTime = 0; // Last write time, the unit depends on the platform
+
+	bool operator==(const SFileStamp& Stamp) const
+	{
+		return bExists == Stamp.bExists && iSize == Stamp.iSize && iTime == Stamp.iTime;
+	}
+
+	bool operator!=(const SFileStamp& Stamp) const
+	{
+		return !(*this == Stamp);
+	}
+};
+
+inline SFileStamp GetFileStamp(const char* szFileName)
+{
+	SFileStamp
+		Stamp;
+
+#if defined _WIN32
+
+	WIN32_FILE_ATTRIBUTE_DATA
+		Data;
+
+	if (!GetFileAttributesExA(szFileName, GetFileExInfoStandard, &Data))
+		return Stamp;
+
+	Stamp.iSize = ((unsigned long long)Data.nFileSizeHigh << 32) | Data.nFileSizeLow;
+	Stamp.iTime = ((unsigned long long)Data.ftLastWriteTime.dwHighDateTime << 32) | Data.ftLastWriteTime.dwLowDateTime;
+
+#else
+
+	struct stat
+		FileStat;
+
+	if (stat(szFileName, &FileStat) != 0)
+		return Stamp;
+
+	Stamp.iSize = (unsigned long long)FileStat.st_size;
+	Stamp.iTime = (unsigned long long)FileStat.st_mtime;
+
+#endif
+
+	Stamp.bExists = true;
+	return Stamp;
+}
+
+// ------------------------------------------------------
+
+class FileWatcher
+{
+private:
+
+	BackgroundWorker
+				m_Worker;
+
+public:
+
+	static constexpr unsigned int
+				MIN_INTERVAL = BackgroundWorker::STOP_CHECK_INTERVAL; // ms
+
+	FileWatcher()
+	{
+
+	}
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// Starts watching vFiles, fnChanged is called on the watcher thread after a poll found any changes.
+	// The current state of the files is taken right away, so changes from now on are detected.
+	// iInterval is in ms, anything below MIN_INTERVAL is raised to it.
+	void Start(const std::vector<std::string>& vFiles, unsigned int iInterval, std::function<void()> fnChanged)
+	{
+		std::vector<SFileStamp>
+			vStamps;
+
+		Stop();
+
+		iInterval = std::max(iInterval, MIN_INTERVAL);
+
+		for (auto &File : vFiles)
+			vStamps.push_back(GetFileStamp(File.c_str()));
+
+		m_Worker.Start([vFiles, vStamps, iInterval, fnChanged](const BackgroundWorker::Token& Token) mutable
+		{
+			SFileStamp
+				Stamp;
+
+			bool
+				bChanged;
+
+			while (Token.Sleep(iInterval))
+			{
+				bChanged = false;
+
+				for (size_t i = 0; i < vFiles.size(); ++i)
+				{
+					Stamp = GetFileStamp(vFiles[i].c_str());
+
+					if (Stamp != vStamps[i])
+					{
+						vStamps[i] = Stamp;
+						bChanged = true;
+					}
+				}
+
+				if (bChanged)
+					fnChanged();
+			}
+		});
+	}
+
+	// Waits for the thread to end, see BackgroundWorker::Stop(). A running fnChanged is waited for as well.
+	void Stop()
+	{
+		m_Worker.Stop();
+	}
+
+	bool IsRunning() const
+	{
+		return m_Worker.IsRunning();
+	}
+};
+
+// ------------------------------------------------------
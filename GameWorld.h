@@ -0,0 +1,318 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Game World
+
+World implementation for GTA III, VC and SA using the plugin SDK. See World.h.
+
+*/// ----------------------------------------------------
+
+#include "plugin.h"
+#include <CEntity.h>
+#include <CPlayerPed.h>
+#include <CVehicle.h>
+#include <CCamera.h>
+#include <CPools.h>
+#include <CTheScripts.h>
+#include <CTimer.h>
+#include <extensions/ScriptCommands.h>
+
+#include "World.h"
+
+#if defined GTAVC && !defined eEntityStatus // Missing in CEntity.h for older plugin SDK versions
+#include <eEntityStatus.h>
+#endif
+
+#if defined GTAVC && !defined eEntityType
+enum PLUGIN_API eEntityType // Missing in VC for older plugin SDK versions
+{
+	ENTITY_TYPE_NOTHING = 0,
+	ENTITY_TYPE_BUILDING = 1,
+	ENTITY_TYPE_VEHICLE = 2,
+	ENTITY_TYPE_PED = 3,
+	ENTITY_TYPE_OBJECT = 4
+};
+#endif
+
+#if defined GTASA
+#define VEHICLE_STATUS(v) (v)->m_nStatus
+#define PED_VEHICLE(p) (p)->m_pVehicle
+#else
+#define VEHICLE_STATUS(v) (v)->m_nState
+#define PED_VEHICLE(p) (p)->m_pMyVehicle
+#endif
+
+// ------------------------------------------------------
+
+class GameWorld
+{
+private:
+
+	static CVehicle* _Vehicle(int iVehicle)
+	{
+		return CPools::ms_pVehiclePool->GetAt(iVehicle);
+	}
+
+	static CPed* _Ped(int iPed)
+	{
+		return CPools::ms_pPedPool->GetAt(iPed);
+	}
+
+	static SVector3 _Vector(const CVector& vec)
+	{
+		return SVector3(vec.x, vec.y, vec.z);
+	}
+
+	static CEntity* _Collision(int iVehicle)
+	{
+#if defined GTAVC
+		return _Vehicle(iVehicle)->m_pPhysColliding;
+#else
+		return _Vehicle(iVehicle)->m_pDamageEntity;
+#endif
+	}
+
+public:
+
+	// Clock
+
+	unsigned int GetTime()
+	{
+		return (unsigned int)GetTickCount();
+	}
+
+	float GetTimeStep()
+	{
+		return CTimer::ms_fTimeStep;
+	}
+
+	// Game state
+
+	bool IsPlayerPlaying()
+	{
+		return plugin::Command<plugin::Commands::IS_PLAYER_PLAYING>(0);
+	}
+
+	bool IsOnMission()
+	{
+		return CTheScripts::IsPlayerOnAMission();
+	}
+
+	bool IsMiniGameInProgress()
+	{
+#if defined GTASA
+		return CTheScripts::bMiniGameInProgress;
+#else
+		return false;
+#endif
+	}
+
+	int GetPlayerPed()
+	{
+		CPlayerPed
+			*pPlayerPed;
+
+#if defined GTASA
+		pPlayerPed = FindPlayerPed(0);
+#else
+		pPlayerPed = FindPlayerPed();
+#endif
+
+		return pPlayerPed ? CPools::ms_pPedPool->GetIndex(pPlayerPed) : -1;
+	}
+
+	int GetPlayerVehicle()
+	{
+		CVehicle
+			*pPlayerVehicle;
+
+#if defined GTASA
+		pPlayerVehicle = FindPlayerVehicle(0, false);
+#else
+		pPlayerVehicle = FindPlayerVehicle();
+#endif
+
+		return pPlayerVehicle ? CPools::ms_pVehiclePool->GetIndex(pPlayerVehicle) : -1;
+	}
+
+	// Vehicle pool
+
+	int GetVehiclePoolSize()
+	{
+		return CPools::ms_pVehiclePool->m_nSize;
+	}
+
+	bool IsVehicleSlotUsed(int iVehicle)
+	{
+		return !CPools::ms_pVehiclePool->IsFreeSlotAtIndex(iVehicle);
+	}
+
+	SVector3 GetVehiclePosition(int iVehicle)
+	{
+		return _Vector(_Vehicle(iVehicle)->GetPosition());
+	}
+
+	SVector3 GetVehicleVelocity(int iVehicle)
+	{
+		return _Vector(_Vehicle(iVehicle)->m_vecMoveSpeed);
+	}
+
+	void SetVehicleVelocity(int iVehicle, const SVector3& vecVelocity)
+	{
+		_Vehicle(iVehicle)->m_vecMoveSpeed = CVector(vecVelocity.x, vecVelocity.y, vecVelocity.z);
+	}
+
+	float GetVehicleBoundRadius(int iVehicle)
+	{
+		return _Vehicle(iVehicle)->GetBoundRadius();
+	}
+
+	float GetVehicleHealth(int iVehicle)
+	{
+		return _Vehicle(iVehicle)->m_fHealth;
+	}
+
+	int GetVehicleModel(int iVehicle)
+	{
+		return _Vehicle(iVehicle)->m_nModelIndex;
+	}
+
+	bool IsMissionVehicle(int iVehicle)
+	{
+		return _Vehicle(iVehicle)->m_nCreatedBy == MISSION_VEHICLE;
+	}
+
+	int GetVehicleDriver(int iVehicle)
+	{
+		CPed
+			*pDriver = _Vehicle(iVehicle)->m_pDriver;
+
+		return pDriver ? CPools::ms_pPedPool->GetIndex(pDriver) : -1;
+	}
+
+	int GetVehicleCollision(int iVehicle)
+	{
+		CEntity
+			*pEntity = _Collision(iVehicle);
+
+		if (pEntity == nullptr || pEntity->m_nType != eEntityType::ENTITY_TYPE_VEHICLE)
+			return -1;
+
+		return CPools::ms_pVehiclePool->GetIndex(static_cast<CVehicle*>(pEntity));
+	}
+
+	int GetVehicleCollisionPed(int iVehicle)
+	{
+		CEntity
+			*pEntity = _Collision(iVehicle);
+
+		if (pEntity == nullptr || pEntity->m_nType != eEntityType::ENTITY_TYPE_PED)
+			return -1;
+
+		return CPools::ms_pPedPool->GetIndex(static_cast<CPed*>(pEntity));
+	}
+
+	bool PromoteVehicle(int iVehicle)
+	{
+		CVehicle
+			*pVehicle = _Vehicle(iVehicle);
+
+		if (VEHICLE_STATUS(pVehicle) != STATUS_SIMPLE)
+			return false;
+
+		VEHICLE_STATUS(pVehicle) = STATUS_PHYSICS;
+		return true;
+	}
+
+	void DemoteVehicle(int iVehicle)
+	{
+		CVehicle
+			*pVehicle = _Vehicle(iVehicle);
+
+		// Leave vehicles alone if the game changed their status in the meantime (ie. wrecked or abandoned)
+
+		if (pVehicle->m_pDriver && VEHICLE_STATUS(pVehicle) == STATUS_PHYSICS)
+			VEHICLE_STATUS(pVehicle) = STATUS_SIMPLE;
+	}
+
+	// Ped pool
+
+	int GetPedPoolSize()
+	{
+		return CPools::ms_pPedPool->m_nSize;
+	}
+
+	bool IsPedSlotUsed(int iPed)
+	{
+		return !CPools::ms_pPedPool->IsFreeSlotAtIndex(iPed);
+	}
+
+	SVector3 GetPedPosition(int iPed)
+	{
+		return _Vector(_Ped(iPed)->GetPosition());
+	}
+
+	void SetPedPosition(int iPed, const SVector3& vecPos)
+	{
+		plugin::Command<plugin::Commands::SET_CHAR_COORDINATES>(_Ped(iPed), vecPos.x, vecPos.y, vecPos.z);
+	}
+
+	SVector3 GetPedVelocity(int iPed)
+	{
+		return _Vector(_Ped(iPed)->m_vecMoveSpeed);
+	}
+
+	float GetPedBoundRadius(int iPed)
+	{
+		return _Ped(iPed)->GetBoundRadius();
+	}
+
+	float GetPedHealth(int iPed)
+	{
+		return _Ped(iPed)->m_fHealth;
+	}
+
+	int GetPedModel(int iPed)
+	{
+		return _Ped(iPed)->m_nModelIndex;
+	}
+
+	bool IsMissionPed(int iPed)
+	{
+		return _Ped(iPed)->m_nCreatedBy == PED_MISSION;
+	}
+
+	int GetPedVehicle(int iPed)
+	{
+		CPed
+			*pPed = _Ped(iPed);
+
+		if (!pPed->bInVehicle || PED_VEHICLE(pPed) == nullptr)
+			return -1;
+
+		return CPools::ms_pVehiclePool->GetIndex(PED_VEHICLE(pPed));
+	}
+
+	// Swapping
+
+	void WarpPedOutOfVehicle(int iPed)
+	{
+		CPed
+			*pPed = _Ped(iPed);
+
+		plugin::Command<plugin::Commands::WARP_CHAR_FROM_CAR_TO_COORD>(pPed, pPed->GetPosition().x, pPed->GetPosition().y, pPed->GetPosition().z + 15.0f);
+	}
+
+	void WarpPedIntoVehicle(int iPed, int iVehicle)
+	{
+		plugin::Command<plugin::Commands::WARP_CHAR_INTO_CAR>(_Ped(iPed), _Vehicle(iVehicle));
+	}
+
+	void RestoreCamera()
+	{
+		TheCamera.RestoreWithJumpCut();
+	}
+};
+
+// ------------------------------------------------------
@@ -0,0 +1,283 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Mapped File
+
+Read-only view of a whole file. The file is memory mapped (MapViewOfFile/mmap) so it can be used without copying it
+first. Files that can't be mapped are read into a buffer instead.
+
+Only map files that aren't written to while they're open. Reading a part of a mapped file that was truncated meanwhile
+crashes on POSIX (SIGBUS), and on Windows the mapping makes writing the file fail. Read() always uses a buffer.
+
+The data is not zero terminated.
+
+WriteFileAtomic() is the counterpart for writing a whole file.
+
+*/// ----------------------------------------------------
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string>
+
+#if defined _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Windows.h would define min/max macros that break std::min/std::max in every file included after this
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ------------------------------------------------------
+
+class MappedFile
+{
+private:
+
+	const char	*m_pData = nullptr;
+	size_t		m_iSize = 0;
+
+	bool		m_bMapped = false;
+	char		*m_pBuffer = nullptr;
+
+	bool _Map(const char* szFileName)
+	{
+#if defined _WIN32
+
+		HANDLE
+			hFile,
+			hMapping;
+
+		LARGE_INTEGER
+			iSize;
+
+		hFile = CreateFileA(szFileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+		if (hFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		if (!GetFileSizeEx(hFile, &iSize) || iSize.QuadPart == 0 || (unsigned long long)iSize.QuadPart > (size_t)-1)
+		{
+			CloseHandle(hFile);
+			return false;
+		}
+
+		hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(hFile);
+
+		if (!hMapping)
+			return false;
+
+		// The view keeps the mapping alive
+
+		m_pData = (const char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(hMapping);
+
+		if (!m_pData)
+			return false;
+
+		m_iSize = (size_t)iSize.QuadPart;
+
+#else
+
+		int
+			iFile;
+
+		struct stat
+			FileStat;
+
+		void
+			*pData;
+
+		iFile = open(szFileName, O_RDONLY);
+
+		if (iFile == -1)
+			return false;
+
+		if (fstat(iFile, &FileStat) != 0 || !S_ISREG(FileStat.st_mode) || FileStat.st_size == 0)
+		{
+			close(iFile);
+			return false;
+		}
+
+		pData = mmap(nullptr, (size_t)FileStat.st_size, PROT_READ, MAP_PRIVATE, iFile, 0);
+		close(iFile);
+
+		if (pData == MAP_FAILED)
+			return false;
+
+		m_pData = (const char*)pData;
+		m_iSize = (size_t)FileStat.st_size;
+
+#endif
+
+		m_bMapped = true;
+		return true;
+	}
+
+	bool _Read(const char* szFileName)
+	{
+		FILE
+			*pFile;
+
+		long long
+			iLen;
+
+#if defined _WIN32
+		if (fopen_s(&pFile, szFileName, "rb"))
+			return false;
+#else
+		if (!(pFile = fopen(szFileName, "rb")))
+			return false;
+#endif
+
+#if defined _WIN32
+		_fseeki64(pFile, 0, SEEK_END);
+		iLen = _ftelli64(pFile);
+		_fseeki64(pFile, 0, SEEK_SET);
+#else
+		fseek(pFile, 0, SEEK_END);
+		iLen = (long long)ftell(pFile);
+		fseek(pFile, 0, SEEK_SET);
+#endif
+
+		if (iLen < 0)
+		{
+			fclose(pFile);
+			return false;
+		}
+
+		if (iLen > 0)
+		{
+			m_pBuffer = new char[(size_t)iLen];
+			m_iSize = fread(m_pBuffer, sizeof(char), (size_t)iLen, pFile);
+			m_pData = m_pBuffer;
+		}
+
+		fclose(pFile);
+
+		return true;
+	}
+
+public:
+
+	MappedFile()
+	{
+
+	}
+
+	MappedFile(const char* szFileName)
+	{
+		Open(szFileName);
+	}
+
+	~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Returns false if the file can't be opened. An empty file is opened successfully with a size of 0.
+	// bReadFallback: Read files that can't be mapped into a buffer, otherwise fail for them (ie. empty files or pipes).
+	bool Open(const char* szFileName, bool bReadFallback = true)
+	{
+		Close();
+
+		if (_Map(szFileName))
+			return true;
+
+		return bReadFallback && _Read(szFileName);
+	}
+
+	// Same as Open(), but the file is always read into a buffer.
+	bool Read(const char* szFileName)
+	{
+		Close();
+
+		return _Read(szFileName);
+	}
+
+	void Close()
+	{
+		if (m_bMapped)
+		{
+#if defined _WIN32
+			UnmapViewOfFile(m_pData);
+#else
+			munmap((void*)m_pData, m_iSize);
+#endif
+		}
+
+		delete[] m_pBuffer;
+
+		m_pData = nullptr;
+		m_iSize = 0;
+		m_bMapped = false;
+		m_pBuffer = nullptr;
+	}
+
+	const char* GetData() const
+	{
+		return m_pData;
+	}
+
+	size_t GetSize() const
+	{
+		return m_iSize;
+	}
+
+	bool IsMapped() const
+	{
+		return m_bMapped;
+	}
+};
+
+// ------------------------------------------------------
+
+// Writes to a temporary file next to the target first and replaces the target with it, so readers never see a
+// partially written file.
+inline bool WriteFileAtomic(const char* szFileName, const void* pData, size_t iSize)
+{
+	std::string
+		TempName = std::string(szFileName) + ".tmp";
+
+	FILE
+		*pFile;
+
+	bool
+		bWritten;
+
+#if defined _WIN32
+	if (fopen_s(&pFile, TempName.c_str(), "wb"))
+		return false;
+#else
+	if (!(pFile = fopen(TempName.c_str(), "wb")))
+		return false;
+#endif
+
+	bWritten = fwrite(pData, sizeof(char), iSize, pFile) == iSize;
+	bWritten = fflush(pFile) == 0 && bWritten;
+	bWritten = fclose(pFile) == 0 && bWritten;
+
+#if defined _WIN32
+	bWritten = bWritten && MoveFileExA(TempName.c_str(), szFileName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	bWritten = bWritten && rename(TempName.c_str(), szFileName) == 0;
+#endif
+
+	if (!bWritten)
+		remove(TempName.c_str());
+
+	return bWritten;
+}
+
+// ------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,380 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Metrics
+
+Per-tick counters for the swap engine: how long a tick took, how many pool slots it looked at, how many vehicles it
+promoted to physics, how many swaps it did and why it stopped early. The values are collected into log2 histograms
+and appended to DoNotCrash.metrics.log every METRICS_DUMP_INTERVAL ms, then reset.
+
+Recording a tick is a few increments and two clock reads, so it can stay enabled in release builds. For a dump the
+game thread only copies the counters into a ring buffer (see SpscRing.h), a writer thread does the file I/O. If the
+writer falls behind, the counters are kept and go into the next dump.
+Everything is compiled out unless DNC_METRICS is defined.
+
+Usage:
+
+- Call BeginTick() and EndTick(reason) around each tick, see TickResult::.
+- Call the Add* functions in between.
+- Stop() writes the counters since the last dump and waits for the writer. Call it on game shutdown, see
+  BackgroundWorker.h.
+
+*/// ----------------------------------------------------
+
+#include <stdio.h>
+#include <stddef.h>
+
+// ------------------------------------------------------
+
+// Why a tick ended, collected by the metrics and returned by SwapEngine's tick.
+
+namespace TickResult
+{
+	enum
+	{
+		SWAPPED = 0,
+		INACTIVE, // Disabled in the config
+		DELAY, // SwapDelay since the last swap didn't pass yet
+		NOT_PLAYING,
+		ON_MISSION,
+		MINIGAME,
+		NO_VEHICLE, // Player is a passenger, or on foot with no ped swaps enabled
+		NO_COLLISION,
+		LOW_HEALTH, // Target is burning or wrecked
+		SWAP_BACK, // The player left the target less than SwapBackDelay ago
+		FILTERED, // Target model, mission vehicle or mission ped is filtered out, see ModelFilter.h
+
+		MAX
+	};
+
+	inline const char* GetName(int iResult)
+	{
+		static const char* const s_aszNames[MAX] =
+		{
+			"swapped", "inactive", "delay", "not playing", "on mission", "minigame", "no vehicle", "no collision", "low health", "swap back", "filtered"
+		};
+
+		return iResult >= 0 && iResult < MAX ? s_aszNames[iResult] : "unknown";
+	}
+}
+
+// ------------------------------------------------------
+
+#if defined DNC_METRICS
+
+#include <chrono>
+#include <memory>
+
+#include "BackgroundWorker.h"
+#include "SpscRing.h"
+
+constexpr unsigned int METRICS_DUMP_INTERVAL = 10000; // ms
+constexpr unsigned int METRICS_RING_SIZE = 4; // Dumps
+constexpr unsigned int METRICS_WRITE_INTERVAL = 1000; // ms, how often the writer looks for new dumps
+
+#define METRICS_LOG_FILE "DoNotCrash.metrics.log"
+
+// Bucket 0 counts zeros, bucket i counts values in [2^(i-1), 2^i).
+
+class Log2Histogram
+{
+public:
+
+	static constexpr int
+				BUCKET_COUNT = 48;
+
+private:
+
+	unsigned long long
+				m_aBuckets[BUCKET_COUNT] = {},
+				m_iCount = 0,
+				m_iSum = 0,
+				m_iMax = 0;
+
+	static int _Bucket(unsigned long long iValue)
+	{
+		int
+			iBucket = 0;
+
+		while (iValue && iBucket < BUCKET_COUNT - 1)
+		{
+			iValue >>= 1;
+			++iBucket;
+		}
+
+		return iBucket;
+	}
+
+public:
+
+	void Add(unsigned long long iValue)
+	{
+		++m_aBuckets[_Bucket(iValue)];
+		++m_iCount;
+		m_iSum += iValue;
+
+		if (iValue > m_iMax)
+			m_iMax = iValue;
+	}
+
+	void Reset()
+	{
+		*this = Log2Histogram();
+	}
+
+	unsigned long long GetCount() const
+	{
+		return m_iCount;
+	}
+
+	// Upper bound of the bucket that contains the given fraction (0-1) of the values.
+	unsigned long long GetPercentile(double dFraction) const
+	{
+		unsigned long long
+			iSeen = 0,
+			iWanted = (unsigned long long)(dFraction * (double)m_iCount + 0.5);
+
+		for (int i = 0; i < BUCKET_COUNT; ++i)
+		{
+			iSeen += m_aBuckets[i];
+
+			if (iSeen >= iWanted && iSeen > 0)
+				return i == 0 ? 0 : (1ULL << i) - 1;
+		}
+
+		return m_iMax;
+	}
+
+	void Write(FILE* pFile, const char* szName, const char* szUnit) const
+	{
+		fprintf(pFile, "%-10s n=%llu mean=%.1f p50<=%llu p99<=%llu max=%llu %s\n", szName, m_iCount,
+			m_iCount ? (double)m_iSum / (double)m_iCount : 0.0, GetPercentile(0.5), GetPercentile(0.99), m_iMax, szUnit);
+
+		for (int i = 0; i < BUCKET_COUNT; ++i)
+			if (m_aBuckets[i])
+				fprintf(pFile, "  [%llu, %llu] %llu\n", i == 0 ? 0 : 1ULL << (i - 1), i == 0 ? 0 : (1ULL << i) - 1, m_aBuckets[i]);
+	}
+};
+
+// ------------------------------------------------------
+
+class Metrics
+{
+private:
+
+	// Everything one dump writes, copied on the game thread and written on the writer thread
+
+	struct SDump
+	{
+		double		dSeconds;
+
+		unsigned long long
+					aResults[TickResult::MAX],
+					iTotalSwaps;
+
+		long long	iConfigLoadTime; // -1 if it was written before
+
+		Log2Histogram
+					TickTime,
+					SlotsVisited,
+					Promoted;
+	};
+
+	using DumpRing = SpscRing<SDump, METRICS_RING_SIZE>;
+
+	std::shared_ptr<DumpRing>
+				m_pRing; // Owned by the writer as well, see BackgroundWorker.h
+
+	BackgroundWorker
+				m_Writer;
+
+	std::chrono::steady_clock::time_point
+				m_tTickStart,
+				m_tLastDump = std::chrono::steady_clock::now();
+
+	// Current tick
+
+	unsigned int
+				m_iSlotsVisited = 0,
+				m_iPromoted = 0,
+				m_iSwaps = 0;
+
+	// Since the last dump
+
+	Log2Histogram
+				m_TickTime,
+				m_SlotsVisited,
+				m_Promoted;
+
+	unsigned long long
+				m_aResults[TickResult::MAX] = {},
+				m_iTotalSwaps = 0;
+
+	long long	m_iConfigLoadTime = -1;
+	bool		m_bConfigLoadTimeWritten = false;
+
+	static void _WriteDump(const SDump& Dump)
+	{
+		FILE
+			*pFile;
+
+#if defined _WIN32
+		if (fopen_s(&pFile, METRICS_LOG_FILE, "a"))
+			return;
+#else
+		if (!(pFile = fopen(METRICS_LOG_FILE, "a")))
+			return;
+#endif
+
+		fprintf(pFile, "--- %.1f s, %llu ticks, %llu swaps\n", Dump.dSeconds, Dump.TickTime.GetCount(), Dump.iTotalSwaps);
+
+		if (Dump.iConfigLoadTime >= 0)
+			fprintf(pFile, "config load %lld us\n", Dump.iConfigLoadTime);
+
+		for (int i = 0; i < TickResult::MAX; ++i)
+			fprintf(pFile, "%-12s %llu\n", TickResult::GetName(i), Dump.aResults[i]);
+
+		Dump.TickTime.Write(pFile, "tick", "ns");
+		Dump.SlotsVisited.Write(pFile, "slots", "");
+		Dump.Promoted.Write(pFile, "promoted", "");
+
+		fclose(pFile);
+	}
+
+	static void _Write(DumpRing& Ring, const BackgroundWorker::Token& Token)
+	{
+		SDump
+			Dump;
+
+		bool
+			bRunning;
+
+		do
+		{
+			bRunning = Token.Sleep(METRICS_WRITE_INTERVAL);
+
+			while (Ring.Pop(&Dump, 1))
+				_WriteDump(Dump);
+		}
+		while (bRunning);
+	}
+
+	void _Dump(std::chrono::steady_clock::time_point tNow)
+	{
+		SDump
+			Dump;
+
+		if (!m_pRing)
+		{
+			m_pRing = std::make_shared<DumpRing>();
+
+			m_Writer.Start([pRing = m_pRing](const BackgroundWorker::Token& Token)
+			{
+				_Write(*pRing, Token);
+			});
+		}
+
+		Dump.dSeconds = std::chrono::duration<double>(tNow - m_tLastDump).count();
+		Dump.iTotalSwaps = m_iTotalSwaps;
+		Dump.iConfigLoadTime = m_bConfigLoadTimeWritten ? -1 : m_iConfigLoadTime;
+		Dump.TickTime = m_TickTime;
+		Dump.SlotsVisited = m_SlotsVisited;
+		Dump.Promoted = m_Promoted;
+
+		for (int i = 0; i < TickResult::MAX; ++i)
+			Dump.aResults[i] = m_aResults[i];
+
+		// Keep collecting into the next dump if the writer is behind
+
+		if (!m_pRing->Push(Dump))
+			return;
+
+		if (m_iConfigLoadTime >= 0)
+			m_bConfigLoadTimeWritten = true;
+
+		m_TickTime.Reset();
+		m_SlotsVisited.Reset();
+		m_Promoted.Reset();
+
+		for (auto &iCount : m_aResults)
+			iCount = 0;
+
+		m_iTotalSwaps = 0;
+		m_tLastDump = tNow;
+	}
+
+public:
+
+	Metrics()
+	{
+
+	}
+
+	Metrics(const Metrics&) = delete;
+	Metrics& operator=(const Metrics&) = delete;
+
+	void BeginTick()
+	{
+		m_iSlotsVisited = 0;
+		m_iPromoted = 0;
+		m_iSwaps = 0;
+
+		m_tTickStart = std::chrono::steady_clock::now();
+	}
+
+	void AddSlotsVisited(size_t iCount)
+	{
+		m_iSlotsVisited += (unsigned int)iCount;
+	}
+
+	void AddPromoted()
+	{
+		++m_iPromoted;
+	}
+
+	void AddSwap()
+	{
+		++m_iSwaps;
+	}
+
+	// iResult: See TickResult::
+	void EndTick(int iResult)
+	{
+		std::chrono::steady_clock::time_point
+			tNow = std::chrono::steady_clock::now();
+
+		m_TickTime.Add((unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(tNow - m_tTickStart).count());
+		m_SlotsVisited.Add(m_iSlotsVisited);
+		m_Promoted.Add(m_iPromoted);
+
+		if (iResult >= 0 && iResult < TickResult::MAX)
+			++m_aResults[iResult];
+
+		m_iTotalSwaps += m_iSwaps;
+
+		if (tNow - m_tLastDump >= std::chrono::milliseconds(METRICS_DUMP_INTERVAL))
+			_Dump(tNow);
+	}
+
+	// Microseconds, written once with the next dump.
+	void SetConfigLoadTime(long long iTime)
+	{
+		m_iConfigLoadTime = iTime;
+		m_bConfigLoadTimeWritten = false;
+	}
+
+	// Writes what was collected since the last dump and waits for the writer thread.
+	void Stop()
+	{
+		if (m_TickTime.GetCount())
+			_Dump(std::chrono::steady_clock::now());
+
+		m_Writer.Stop();
+		m_pRing.reset();
+	}
+};
+
+#endif
+
+// ------------------------------------------------------
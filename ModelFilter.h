@@ -0,0 +1,80 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Model Filter
+
+Allow/block list of model IDs, compiled into a bitset so checking a model is a single bit test.
+
+If the allow list has any entries, only those models are allowed, otherwise all of them are. Blocked models are never
+allowed, even if they are on the allow list too. Entries that are 0 or negative are ignored, so the unused tail of a
+fixed size config array doesn't matter. Models from MODEL_COUNT on can't be listed, they are only allowed if
+there is no allow list.
+
+Usage:
+
+- Call Build() whenever the lists change.
+- Call IsAllowed() per candidate.
+
+*/// ----------------------------------------------------
+
+#include <stddef.h>
+#include <string.h>
+
+// ------------------------------------------------------
+
+class ModelFilter
+{
+public:
+
+	static constexpr unsigned int
+				MODEL_COUNT = 32768; // Model IDs the bitset covers, SA has the most with about 20000
+
+private:
+
+	static constexpr unsigned int
+				WORD_COUNT = MODEL_COUNT / 64;
+
+	unsigned long long
+				m_aWords[WORD_COUNT];
+
+	bool		m_bOthersAllowed = true; // Models outside the bitset
+
+public:
+
+	ModelFilter()
+	{
+		memset(m_aWords, 0xFF, sizeof(m_aWords));
+	}
+
+	void Build(const int* pAllowed, size_t iAllowedCount, const int* pBlocked, size_t iBlockedCount)
+	{
+		bool
+			bAllowList = false;
+
+		for (size_t i = 0; i < iAllowedCount; ++i)
+			if (pAllowed[i] > 0)
+				bAllowList = true;
+
+		memset(m_aWords, bAllowList ? 0x00 : 0xFF, sizeof(m_aWords));
+		m_bOthersAllowed = !bAllowList;
+
+		for (size_t i = 0; i < iAllowedCount; ++i)
+			if (pAllowed[i] > 0 && (unsigned int)pAllowed[i] < MODEL_COUNT)
+				m_aWords[pAllowed[i] / 64] |= 1ULL << (pAllowed[i] % 64);
+
+		for (size_t i = 0; i < iBlockedCount; ++i)
+			if (pBlocked[i] > 0 && (unsigned int)pBlocked[i] < MODEL_COUNT)
+				m_aWords[pBlocked[i] / 64] &= ~(1ULL << (pBlocked[i] % 64));
+	}
+
+	bool IsAllowed(int iModel) const
+	{
+		if ((unsigned int)iModel >= MODEL_COUNT)
+			return m_bOthersAllowed;
+
+		return (m_aWords[iModel / 64] >> (iModel % 64)) & 1;
+	}
+};
+
+// ------------------------------------------------------
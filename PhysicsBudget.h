@@ -0,0 +1,199 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Physics Budget
+
+Decides which vehicles near the player are switched to full physics processing and which go back to simple processing.
+
+Usage:
+
+- Call SetLimits() whenever the config changes.
+- Every tick call Begin(), AddCandidate() for every vehicle within the demote radius (bigger than the promote radius)
+  and then Apply().
+- Call OnDestroyed() when a vehicle is destroyed.
+
+Candidates are ranked by time to contact with the player (closest first for vehicles that are not closing in),
+only the best iMaxPromoted are promoted. A promoted vehicle stays promoted until it leaves the demote radius or is
+pushed out of the budget by a vehicle with a higher priority, so vehicles don't flicker at the edge of the radius.
+
+Only vehicles that were promoted by this class are ever demoted.
+
+*/// ----------------------------------------------------
+
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+// ------------------------------------------------------
+
+class PhysicsBudget
+{
+private:
+
+	struct SCandidate
+	{
+		int		iIndex;
+		float	fDistSq;
+		float	fTimeToContact;
+	};
+
+	unsigned int
+				m_iMaxPromoted = 32;
+
+	float		m_fPromoteRadiusSq = 40.0f * 40.0f;
+
+	std::vector<SCandidate>
+				m_vCandidates;
+
+	// Indexes promoted by us and the tick they were last seen as candidate
+
+	std::vector<int>
+				m_vPromoted;
+
+	std::vector<unsigned int>
+				m_vSeenTick;
+
+	std::vector<bool>
+				m_vIsPromoted;
+
+	unsigned int
+				m_iTick = 0;
+
+	bool _IsPromoted(int iIndex) const
+	{
+		return (size_t)iIndex < m_vIsPromoted.size() && m_vIsPromoted[iIndex];
+	}
+
+	void _SetPromoted(int iIndex, bool bPromoted)
+	{
+		if ((size_t)iIndex >= m_vIsPromoted.size())
+		{
+			m_vIsPromoted.resize((size_t)iIndex + 1, false);
+			m_vSeenTick.resize((size_t)iIndex + 1, 0);
+		}
+
+		if (m_vIsPromoted[iIndex] == bPromoted)
+			return;
+
+		m_vIsPromoted[iIndex] = bPromoted;
+
+		if (bPromoted)
+			m_vPromoted.push_back(iIndex);
+		else
+			m_vPromoted.erase(std::find(m_vPromoted.begin(), m_vPromoted.end(), iIndex));
+	}
+
+public:
+
+	// iMaxPromoted: Maximum amount of vehicles promoted at the same time, 0 = no limit.
+	// fPromoteRadius: Vehicles closer than this are promoted.
+	// The demote radius is the radius used to find candidates, promoted vehicles that are not added as candidate are demoted.
+	void SetLimits(unsigned int iMaxPromoted, float fPromoteRadius)
+	{
+		m_iMaxPromoted = iMaxPromoted;
+		m_fPromoteRadiusSq = fPromoteRadius * fPromoteRadius;
+	}
+
+	void Begin()
+	{
+		m_vCandidates.clear();
+		++m_iTick;
+	}
+
+	// fRelX/Y/Z: Position of the vehicle relative to the player.
+	// fRelVX/VY/VZ: Velocity of the vehicle relative to the player.
+	void AddCandidate(int iIndex, float fRelX, float fRelY, float fRelZ, float fRelVX, float fRelVY, float fRelVZ)
+	{
+		SCandidate
+			Candidate;
+
+		float
+			fClosing;
+
+		if (iIndex < 0)
+			return;
+
+		Candidate.iIndex = iIndex;
+		Candidate.fDistSq = fRelX * fRelX + fRelY * fRelY + fRelZ * fRelZ;
+
+		// Closing speed times distance, positive if the vehicle moves towards the player
+
+		fClosing = -(fRelX * fRelVX + fRelY * fRelVY + fRelZ * fRelVZ);
+
+		Candidate.fTimeToContact = fClosing > 0.0f ? Candidate.fDistSq / fClosing : FLT_MAX;
+
+		m_vCandidates.push_back(Candidate);
+	}
+
+	// fnPromote: bool(int iIndex), switch to physics. Return false if the vehicle can't be promoted (ie. it already uses physics).
+	// fnDemote: void(int iIndex), switch back to simple.
+	template<typename FPromote, typename FDemote>
+	void Apply(FPromote fnPromote, FDemote fnDemote)
+	{
+		unsigned int
+			iKept = 0;
+
+		int
+			iIndex;
+
+		std::sort(m_vCandidates.begin(), m_vCandidates.end(), [](const SCandidate& A, const SCandidate& B)
+		{
+			if (A.fTimeToContact != B.fTimeToContact)
+				return A.fTimeToContact < B.fTimeToContact;
+
+			return A.fDistSq < B.fDistSq;
+		});
+
+		for (auto &Candidate : m_vCandidates)
+		{
+			iIndex = Candidate.iIndex;
+
+			if (_IsPromoted(iIndex))
+			{
+				if (m_iMaxPromoted == 0 || iKept < m_iMaxPromoted)
+				{
+					m_vSeenTick[iIndex] = m_iTick;
+					++iKept;
+				}
+			}
+			else if (Candidate.fDistSq <= m_fPromoteRadiusSq && (m_iMaxPromoted == 0 || iKept < m_iMaxPromoted))
+			{
+				if (fnPromote(iIndex))
+				{
+					_SetPromoted(iIndex, true);
+					m_vSeenTick[iIndex] = m_iTick;
+					++iKept;
+				}
+			}
+		}
+
+		// Demote everything that left the demote radius or didn't fit into the budget anymore
+
+		for (size_t i = m_vPromoted.size(); i > 0; --i)
+		{
+			iIndex = m_vPromoted[i - 1];
+
+			if (m_vSeenTick[iIndex] != m_iTick)
+			{
+				fnDemote(iIndex);
+				_SetPromoted(iIndex, false);
+			}
+		}
+	}
+
+	void OnDestroyed(int iIndex)
+	{
+		if (iIndex >= 0)
+			_SetPromoted(iIndex, false);
+	}
+
+	size_t GetPromotedCount() const
+	{
+		return m_vPromoted.size();
+	}
+};
+
+// ------------------------------------------------------
@@ -0,0 +1,223 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Pool Tracker
+
+Keeps track of the used slots of an entity pool and of an "active" subset of them (ie. vehicles that have a driver),
+so per-tick code only has to look at entities that matter instead of the whole pool.
+
+Usage:
+
+- Call OnCreated()/OnDestroyed() with the pool index from the entity's constructor/destructor events.
+- Call Update() once per tick with a function that tells if a pool index is active.
+- Iterate GetActive() (or GetLive()).
+
+Not every state change has an event (a driver getting into a car for example), so Update() rechecks all active entries
+every tick but only a slice of the inactive ones. An entity becoming active is picked up after at most
+iRefreshTicks ticks, an entity becoming inactive in the next tick.
+
+Pool slots are reused, so an index alone can't tell if it still refers to the same entity. Every slot has a
+generation that is bumped when its entity is destroyed, GetHandle() pairs the index with it. A handle that was taken
+before the entity was destroyed stays invalid even if the slot is used again.
+
+*/// ----------------------------------------------------
+
+#include <stddef.h>
+#include <vector>
+
+// ------------------------------------------------------
+
+struct SSlotHandle
+{
+	int			iIndex = -1;
+
+	unsigned int
+				iGeneration = 0;
+
+	bool operator==(const SSlotHandle& Handle) const
+	{
+		return iIndex == Handle.iIndex && iGeneration == Handle.iGeneration;
+	}
+
+	bool operator!=(const SSlotHandle& Handle) const
+	{
+		return !(*this == Handle);
+	}
+};
+
+// ------------------------------------------------------
+
+class PoolTracker
+{
+private:
+
+	std::vector<int>
+				m_vLive,
+				m_vActive;
+
+	// Position of each pool index in m_vLive/m_vActive, -1 if not in the list
+
+	std::vector<int>
+				m_vLivePos,
+				m_vActivePos;
+
+	std::vector<unsigned int>
+				m_vGenerations; // Per pool index, bumped when the entity is destroyed
+
+	size_t		m_iRefreshCursor = 0;
+
+	static void _Insert(std::vector<int>& vList, std::vector<int>& vPos, int iIndex)
+	{
+		if ((size_t)iIndex >= vPos.size())
+			vPos.resize((size_t)iIndex + 1, -1);
+
+		if (vPos[iIndex] != -1)
+			return;
+
+		vPos[iIndex] = (int)vList.size();
+		vList.push_back(iIndex);
+	}
+
+	static void _Remove(std::vector<int>& vList, std::vector<int>& vPos, int iIndex)
+	{
+		int
+			iPos,
+			iLast;
+
+		if ((size_t)iIndex >= vPos.size() || vPos[iIndex] == -1)
+			return;
+
+		// Swap with the last entry so removing is O(1)
+
+		iPos = vPos[iIndex];
+		iLast = vList.back();
+
+		vList[iPos] = iLast;
+		vPos[iLast] = iPos;
+
+		vList.pop_back();
+		vPos[iIndex] = -1;
+	}
+
+public:
+
+	void OnCreated(int iIndex)
+	{
+		if (iIndex < 0)
+			return;
+
+		_Insert(m_vLive, m_vLivePos, iIndex);
+	}
+
+	void OnDestroyed(int iIndex)
+	{
+		if (iIndex < 0)
+			return;
+
+		_Remove(m_vLive, m_vLivePos, iIndex);
+		_Remove(m_vActive, m_vActivePos, iIndex);
+
+		if ((size_t)iIndex >= m_vGenerations.size())
+			m_vGenerations.resize((size_t)iIndex + 1, 0);
+
+		++m_vGenerations[iIndex];
+	}
+
+	// Generations are kept, so handles taken before stay invalid.
+	void Clear()
+	{
+		m_vLive.clear();
+		m_vActive.clear();
+		m_vLivePos.clear();
+		m_vActivePos.clear();
+		m_iRefreshCursor = 0;
+	}
+
+	bool IsLive(int iIndex) const
+	{
+		return iIndex >= 0 && (size_t)iIndex < m_vLivePos.size() && m_vLivePos[iIndex] != -1;
+	}
+
+	bool IsActive(int iIndex) const
+	{
+		return iIndex >= 0 && (size_t)iIndex < m_vActivePos.size() && m_vActivePos[iIndex] != -1;
+	}
+
+	// Handle for the entity that currently uses the pool index.
+	SSlotHandle GetHandle(int iIndex) const
+	{
+		SSlotHandle
+			Handle;
+
+		if (iIndex < 0)
+			return Handle;
+
+		Handle.iIndex = iIndex;
+		Handle.iGeneration = (size_t)iIndex < m_vGenerations.size() ? m_vGenerations[iIndex] : 0;
+
+		return Handle;
+	}
+
+	// False if the entity was destroyed since the handle was taken.
+	bool IsValid(const SSlotHandle& Handle) const
+	{
+		return IsLive(Handle.iIndex) && GetHandle(Handle.iIndex) == Handle;
+	}
+
+	// fnIsActive: bool(int iIndex), called for every active entry and about 1/iRefreshTicks of the live entries.
+	// Returns the amount of entries that were checked.
+	template<typename F>
+	size_t Update(F fnIsActive, unsigned int iRefreshTicks = 8)
+	{
+		size_t
+			iChecked = m_vActive.size(),
+			iSlice,
+			iIndex;
+
+		// Drop entries that are no longer active. Iterate backwards since _Remove moves the last entry.
+
+		for (size_t i = m_vActive.size(); i > 0; --i)
+		{
+			iIndex = (size_t)m_vActive[i - 1];
+
+			if (!fnIsActive((int)iIndex))
+				_Remove(m_vActive, m_vActivePos, (int)iIndex);
+		}
+
+		// Check a slice of the live entries for ones that became active
+
+		if (m_vLive.empty())
+			return iChecked;
+
+		if (iRefreshTicks == 0)
+			iRefreshTicks = 1;
+
+		iSlice = (m_vLive.size() + iRefreshTicks - 1) / iRefreshTicks;
+
+		for (size_t i = 0; i < iSlice; ++i)
+		{
+			if (m_iRefreshCursor >= m_vLive.size())
+				m_iRefreshCursor = 0;
+
+			iIndex = (size_t)m_vLive[m_iRefreshCursor++];
+
+			if (!IsActive((int)iIndex) && fnIsActive((int)iIndex))
+				_Insert(m_vActive, m_vActivePos, (int)iIndex);
+		}
+
+		return iChecked + iSlice;
+	}
+
+	const std::vector<int>& GetLive() const
+	{
+		return m_vLive;
+	}
+
+	const std::vector<int>& GetActive() const
+	{
+		return m_vActive;
+	}
+};
+
+// ------------------------------------------------------
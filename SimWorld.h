@@ -0,0 +1,599 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Sim World
+
+Synthetic world for running SwapEngine without the game, ie. for profiling on any platform.
+Vehicles drive and peds on foot walk in straight lines inside a square area and wrap around at the edges. The player's
+vehicle reports a collision with the first vehicle and the first ped on foot whose bounding sphere it overlaps, like the
+game does, and every vehicle it overlaps reports a collision with the player's vehicle. On foot, every vehicle that
+overlaps the player reports a collision with the player's ped.
+
+Usage:
+
+- Create the world with the pool sizes you want to test.
+- Call SetListeners()/SetPedListeners() to forward vehicle/ped creation and destruction to the engine.
+- Call Populate() (or SpawnVehicle()/SpawnPed()/SpawnPlayer() for specific setups).
+- Call Step() and the engine's Process() alternately.
+
+*/// ----------------------------------------------------
+
+#include <functional>
+#include <vector>
+
+#include "World.h"
+
+// ------------------------------------------------------
+
+class SimWorld
+{
+private:
+
+	struct SSimVehicle
+	{
+		bool		bUsed = false;
+
+		SVector3	vecPos;
+		SVector3	vecVelocity;
+
+		float		fRadius = 2.5f;
+		float		fHealth = 1000.0f;
+
+		int			iModel = 400;
+		bool		bMission = false;
+
+		int			iDriver = -1;
+		int			iCollision = -1;
+		int			iCollisionPed = -1;
+
+		bool		bPhysics = false;
+	};
+
+	struct SSimPed
+	{
+		bool		bUsed = false;
+		int			iVehicle = -1;
+
+		SVector3	vecPos; // Only used on foot
+		SVector3	vecVelocity;
+
+		float		fRadius = 1.0f;
+		float		fHealth = 100.0f;
+
+		int			iModel = 7;
+		bool		bMission = false;
+	};
+
+	std::vector<SSimVehicle>
+				m_vVehicles;
+
+	std::vector<SSimPed>
+				m_vPeds;
+
+	int			m_iPlayerPed = -1;
+
+	unsigned int
+				m_iTime = 0;
+
+	float		m_fTimeStep = 1.0f;
+	float		m_fAreaSize = 1000.0f;
+
+	bool		m_bPlaying = true;
+	bool		m_bOnMission = false;
+	bool		m_bMiniGame = false;
+
+	unsigned int
+				m_iRandom = 0x12345678;
+
+	unsigned int
+				m_iWarpCount = 0;
+
+	std::function<void(int)>
+				m_fnOnVehicleCreated,
+				m_fnOnVehicleDestroyed,
+				m_fnOnPedCreated,
+				m_fnOnPedDestroyed;
+
+	float _Random(float fMin, float fMax)
+	{
+		// xorshift32
+
+		m_iRandom ^= m_iRandom << 13;
+		m_iRandom ^= m_iRandom >> 17;
+		m_iRandom ^= m_iRandom << 5;
+
+		return fMin + (fMax - fMin) * (float)(m_iRandom & 0xFFFFFF) / (float)0xFFFFFF;
+	}
+
+	int _AllocPed()
+	{
+		for (size_t i = 0; i < m_vPeds.size(); ++i)
+		{
+			if (!m_vPeds[i].bUsed)
+			{
+				m_vPeds[i] = SSimPed();
+				m_vPeds[i].bUsed = true;
+
+				if (m_fnOnPedCreated)
+					m_fnOnPedCreated((int)i);
+
+				return (int)i;
+			}
+		}
+
+		return -1;
+	}
+
+	void _FreePed(int iPed)
+	{
+		if (m_fnOnPedDestroyed)
+			m_fnOnPedDestroyed(iPed);
+
+		m_vPeds[iPed].bUsed = false;
+	}
+
+	float _Wrap(float fCoord) const
+	{
+		float
+			fHalf = m_fAreaSize * 0.5f;
+
+		if (fCoord > fHalf)
+			return fCoord - m_fAreaSize;
+
+		if (fCoord < -fHalf)
+			return fCoord + m_fAreaSize;
+
+		return fCoord;
+	}
+
+public:
+
+	SimWorld(int iVehiclePoolSize, int iPedPoolSize) :
+		m_vVehicles((size_t)iVehiclePoolSize),
+		m_vPeds((size_t)iPedPoolSize)
+	{
+
+	}
+
+	void SetListeners(std::function<void(int)> fnOnVehicleCreated, std::function<void(int)> fnOnVehicleDestroyed)
+	{
+		m_fnOnVehicleCreated = fnOnVehicleCreated;
+		m_fnOnVehicleDestroyed = fnOnVehicleDestroyed;
+	}
+
+	void SetPedListeners(std::function<void(int)> fnOnPedCreated, std::function<void(int)> fnOnPedDestroyed)
+	{
+		m_fnOnPedCreated = fnOnPedCreated;
+		m_fnOnPedDestroyed = fnOnPedDestroyed;
+	}
+
+	void SetSeed(unsigned int iSeed)
+	{
+		m_iRandom = iSeed ? iSeed : 1;
+	}
+
+	void SetPlaying(bool bPlaying)
+	{
+		m_bPlaying = bPlaying;
+	}
+
+	void SetOnMission(bool bOnMission)
+	{
+		m_bOnMission = bOnMission;
+	}
+
+	void SetMiniGame(bool bMiniGame)
+	{
+		m_bMiniGame = bMiniGame;
+	}
+
+	// Returns the vehicle index or -1 if the pool is full.
+	int SpawnVehicle(const SVector3& vecPos, const SVector3& vecVelocity, bool bDriver, int iModel = 400)
+	{
+		for (size_t i = 0; i < m_vVehicles.size(); ++i)
+		{
+			if (m_vVehicles[i].bUsed)
+				continue;
+
+			m_vVehicles[i] = SSimVehicle();
+			m_vVehicles[i].bUsed = true;
+			m_vVehicles[i].vecPos = vecPos;
+			m_vVehicles[i].vecVelocity = vecVelocity;
+			m_vVehicles[i].iModel = iModel;
+
+			if (bDriver)
+			{
+				m_vVehicles[i].iDriver = _AllocPed();
+
+				if (m_vVehicles[i].iDriver != -1)
+					m_vPeds[m_vVehicles[i].iDriver].iVehicle = (int)i;
+			}
+
+			if (m_fnOnVehicleCreated)
+				m_fnOnVehicleCreated((int)i);
+
+			return (int)i;
+		}
+
+		return -1;
+	}
+
+	void DestroyVehicle(int iVehicle)
+	{
+		SSimVehicle
+			&Vehicle = m_vVehicles[iVehicle];
+
+		if (!Vehicle.bUsed)
+			return;
+
+		if (m_fnOnVehicleDestroyed)
+			m_fnOnVehicleDestroyed(iVehicle);
+
+		if (Vehicle.iDriver != -1 && Vehicle.iDriver != m_iPlayerPed)
+			_FreePed(Vehicle.iDriver);
+		else if (Vehicle.iDriver != -1)
+			m_vPeds[Vehicle.iDriver].iVehicle = -1;
+
+		Vehicle.bUsed = false;
+	}
+
+	void SetVehicleHealth(int iVehicle, float fHealth)
+	{
+		m_vVehicles[iVehicle].fHealth = fHealth;
+	}
+
+	void SetMissionVehicle(int iVehicle, bool bMission)
+	{
+		m_vVehicles[iVehicle].bMission = bMission;
+	}
+
+	void SetMissionPed(int iPed, bool bMission)
+	{
+		m_vPeds[iPed].bMission = bMission;
+	}
+
+	// Spawns a ped on foot. Returns the ped index or -1 if the pool is full.
+	int SpawnPed(const SVector3& vecPos, const SVector3& vecVelocity, int iModel = 7)
+	{
+		int
+			iPed = _AllocPed();
+
+		if (iPed != -1)
+		{
+			m_vPeds[iPed].vecPos = vecPos;
+			m_vPeds[iPed].vecVelocity = vecVelocity;
+			m_vPeds[iPed].iModel = iModel;
+		}
+
+		return iPed;
+	}
+
+	// Spawns a driven vehicle and makes its driver the player. Returns the vehicle index or -1.
+	int SpawnPlayer(const SVector3& vecPos, const SVector3& vecVelocity)
+	{
+		int
+			iVehicle = SpawnVehicle(vecPos, vecVelocity, true);
+
+		if (iVehicle != -1)
+			m_iPlayerPed = m_vVehicles[iVehicle].iDriver;
+
+		return iVehicle;
+	}
+
+	// Fills the world with iCount randomly placed vehicles moving in random directions, plus the player in the center.
+	void Populate(int iCount, float fAreaSize, float fMaxSpeed, float fDriverRatio)
+	{
+		m_fAreaSize = fAreaSize;
+
+		SpawnPlayer(SVector3(0.0f, 0.0f, 0.0f), SVector3(fMaxSpeed, 0.0f, 0.0f));
+
+		for (int i = 0; i < iCount; ++i)
+		{
+			SpawnVehicle(
+				SVector3(_Random(-fAreaSize, fAreaSize) * 0.5f, _Random(-fAreaSize, fAreaSize) * 0.5f, _Random(0.0f, 5.0f)),
+				SVector3(_Random(-fMaxSpeed, fMaxSpeed), _Random(-fMaxSpeed, fMaxSpeed), 0.0f),
+				_Random(0.0f, 1.0f) < fDriverRatio,
+				400 + (int)_Random(0.0f, 211.0f)); // SA's vehicle model range
+		}
+	}
+
+	// Moves everything by one frame and updates the collisions with the player.
+	void Step(float fTimeStep = 1.0f, unsigned int iMilliseconds = 20)
+	{
+		int
+			iPlayerVehicle = GetPlayerVehicle();
+
+		float
+			fRadius;
+
+		m_fTimeStep = fTimeStep;
+		m_iTime += iMilliseconds;
+
+		for (auto &Vehicle : m_vVehicles)
+		{
+			if (!Vehicle.bUsed)
+				continue;
+
+			Vehicle.vecPos = Vehicle.vecPos + Vehicle.vecVelocity * fTimeStep;
+			Vehicle.vecPos.x = _Wrap(Vehicle.vecPos.x);
+			Vehicle.vecPos.y = _Wrap(Vehicle.vecPos.y);
+			Vehicle.iCollision = -1;
+			Vehicle.iCollisionPed = -1;
+		}
+
+		for (auto &Ped : m_vPeds)
+		{
+			if (!Ped.bUsed || Ped.iVehicle != -1)
+				continue;
+
+			Ped.vecPos = Ped.vecPos + Ped.vecVelocity * fTimeStep;
+			Ped.vecPos.x = _Wrap(Ped.vecPos.x);
+			Ped.vecPos.y = _Wrap(Ped.vecPos.y);
+		}
+
+		if (m_iPlayerPed == -1)
+			return;
+
+		// On foot
+
+		if (iPlayerVehicle == -1)
+		{
+			for (auto &Vehicle : m_vVehicles)
+			{
+				if (!Vehicle.bUsed)
+					continue;
+
+				fRadius = Vehicle.fRadius + m_vPeds[m_iPlayerPed].fRadius;
+
+				if ((Vehicle.vecPos - m_vPeds[m_iPlayerPed].vecPos).MagnitudeSqr() <= fRadius * fRadius)
+					Vehicle.iCollisionPed = m_iPlayerPed;
+			}
+
+			return;
+		}
+
+		// In a vehicle
+
+		for (size_t i = 0; i < m_vVehicles.size(); ++i)
+		{
+			if (!m_vVehicles[i].bUsed || (int)i == iPlayerVehicle)
+				continue;
+
+			fRadius = m_vVehicles[i].fRadius + m_vVehicles[iPlayerVehicle].fRadius;
+
+			if ((m_vVehicles[i].vecPos - m_vVehicles[iPlayerVehicle].vecPos).MagnitudeSqr() <= fRadius * fRadius)
+			{
+				if (m_vVehicles[iPlayerVehicle].iCollision == -1)
+					m_vVehicles[iPlayerVehicle].iCollision = (int)i;
+
+				m_vVehicles[i].iCollision = iPlayerVehicle;
+			}
+		}
+
+		for (size_t i = 0; i < m_vPeds.size(); ++i)
+		{
+			if (!m_vPeds[i].bUsed || m_vPeds[i].iVehicle != -1)
+				continue;
+
+			fRadius = m_vPeds[i].fRadius + m_vVehicles[iPlayerVehicle].fRadius;
+
+			if ((m_vPeds[i].vecPos - m_vVehicles[iPlayerVehicle].vecPos).MagnitudeSqr() <= fRadius * fRadius)
+			{
+				m_vVehicles[iPlayerVehicle].iCollisionPed = (int)i;
+				break;
+			}
+		}
+	}
+
+	unsigned int GetWarpCount() const
+	{
+		return m_iWarpCount;
+	}
+
+	// Clock
+
+	unsigned int GetTime()
+	{
+		return m_iTime;
+	}
+
+	float GetTimeStep()
+	{
+		return m_fTimeStep;
+	}
+
+	// Game state
+
+	bool IsPlayerPlaying()
+	{
+		return m_bPlaying && m_iPlayerPed != -1;
+	}
+
+	bool IsOnMission()
+	{
+		return m_bOnMission;
+	}
+
+	bool IsMiniGameInProgress()
+	{
+		return m_bMiniGame;
+	}
+
+	int GetPlayerPed()
+	{
+		return m_iPlayerPed;
+	}
+
+	int GetPlayerVehicle()
+	{
+		return m_iPlayerPed != -1 ? m_vPeds[m_iPlayerPed].iVehicle : -1;
+	}
+
+	// Vehicle pool
+
+	int GetVehiclePoolSize()
+	{
+		return (int)m_vVehicles.size();
+	}
+
+	bool IsVehicleSlotUsed(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].bUsed;
+	}
+
+	SVector3 GetVehiclePosition(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].vecPos;
+	}
+
+	SVector3 GetVehicleVelocity(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].vecVelocity;
+	}
+
+	void SetVehicleVelocity(int iVehicle, const SVector3& vecVelocity)
+	{
+		m_vVehicles[iVehicle].vecVelocity = vecVelocity;
+	}
+
+	float GetVehicleBoundRadius(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].fRadius;
+	}
+
+	float GetVehicleHealth(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].fHealth;
+	}
+
+	int GetVehicleModel(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].iModel;
+	}
+
+	bool IsMissionVehicle(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].bMission;
+	}
+
+	int GetVehicleDriver(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].iDriver;
+	}
+
+	int GetVehicleCollision(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].iCollision;
+	}
+
+	int GetVehicleCollisionPed(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].iCollisionPed;
+	}
+
+	bool PromoteVehicle(int iVehicle)
+	{
+		if (m_vVehicles[iVehicle].bPhysics)
+			return false;
+
+		m_vVehicles[iVehicle].bPhysics = true;
+		return true;
+	}
+
+	void DemoteVehicle(int iVehicle)
+	{
+		m_vVehicles[iVehicle].bPhysics = false;
+	}
+
+	bool IsVehiclePromoted(int iVehicle)
+	{
+		return m_vVehicles[iVehicle].bPhysics;
+	}
+
+	// Ped pool
+
+	int GetPedPoolSize()
+	{
+		return (int)m_vPeds.size();
+	}
+
+	bool IsPedSlotUsed(int iPed)
+	{
+		return m_vPeds[iPed].bUsed;
+	}
+
+	SVector3 GetPedPosition(int iPed)
+	{
+		return m_vPeds[iPed].iVehicle != -1 ? m_vVehicles[m_vPeds[iPed].iVehicle].vecPos : m_vPeds[iPed].vecPos;
+	}
+
+	void SetPedPosition(int iPed, const SVector3& vecPos)
+	{
+		m_vPeds[iPed].vecPos = vecPos;
+	}
+
+	SVector3 GetPedVelocity(int iPed)
+	{
+		return m_vPeds[iPed].iVehicle != -1 ? m_vVehicles[m_vPeds[iPed].iVehicle].vecVelocity : m_vPeds[iPed].vecVelocity;
+	}
+
+	float GetPedBoundRadius(int iPed)
+	{
+		return m_vPeds[iPed].fRadius;
+	}
+
+	float GetPedHealth(int iPed)
+	{
+		return m_vPeds[iPed].fHealth;
+	}
+
+	int GetPedModel(int iPed)
+	{
+		return m_vPeds[iPed].iModel;
+	}
+
+	bool IsMissionPed(int iPed)
+	{
+		return m_vPeds[iPed].bMission;
+	}
+
+	int GetPedVehicle(int iPed)
+	{
+		return m_vPeds[iPed].iVehicle;
+	}
+
+	// Swapping
+
+	void WarpPedOutOfVehicle(int iPed)
+	{
+		int
+			iVehicle = m_vPeds[iPed].iVehicle;
+
+		if (iVehicle != -1 && m_vVehicles[iVehicle].iDriver == iPed)
+			m_vVehicles[iVehicle].iDriver = -1;
+
+		if (iVehicle != -1)
+			m_vPeds[iPed].vecPos = m_vVehicles[iVehicle].vecPos;
+
+		m_vPeds[iPed].iVehicle = -1;
+		m_vPeds[iPed].vecVelocity = SVector3();
+		++m_iWarpCount;
+	}
+
+	void WarpPedIntoVehicle(int iPed, int iVehicle)
+	{
+		m_vVehicles[iVehicle].iDriver = iPed;
+		m_vVehicles[iVehicle].iCollision = -1;
+		m_vVehicles[iVehicle].iCollisionPed = -1;
+		m_vPeds[iPed].iVehicle = iVehicle;
+		++m_iWarpCount;
+	}
+
+	void RestoreCamera()
+	{
+
+	}
+};
+
+// ------------------------------------------------------
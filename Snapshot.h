@@ -0,0 +1,63 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Snapshot Exchange
+
+Hands immutable snapshots (ie. a freshly loaded config) from any thread to the game thread without locks.
+
+The producer publishes a heap allocated object. The consumer checks for one with a single relaxed load per tick and
+only takes ownership with an exchange if there is one. A snapshot that is published before the previous one was
+taken replaces it, the old one is deleted.
+
+Usage:
+
+- Producer: Publish(new T(...)).
+- Consumer: Take() once per tick, if it returns an object copy it where it's needed and delete it.
+
+*/// ----------------------------------------------------
+
+#include <atomic>
+
+// ------------------------------------------------------
+
+template<typename T>
+class SnapshotExchange
+{
+private:
+
+	std::atomic<T*>
+				m_pPending { nullptr };
+
+public:
+
+	SnapshotExchange()
+	{
+
+	}
+
+	~SnapshotExchange()
+	{
+		delete m_pPending.exchange(nullptr);
+	}
+
+	SnapshotExchange(const SnapshotExchange&) = delete;
+	SnapshotExchange& operator=(const SnapshotExchange&) = delete;
+
+	// Takes ownership of pSnapshot.
+	void Publish(T* pSnapshot)
+	{
+		delete m_pPending.exchange(pSnapshot, std::memory_order_acq_rel);
+	}
+
+	// Returns the latest snapshot and passes ownership to the caller, or nullptr if nothing new was published.
+	T* Take()
+	{
+		if (!m_pPending.load(std::memory_order_relaxed))
+			return nullptr;
+
+		return m_pPending.exchange(nullptr, std::memory_order_acquire);
+	}
+};
+
+// ------------------------------------------------------
@@ -0,0 +1,88 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+SPSC Ring
+
+Fixed size ring buffer for exactly one producer thread and one consumer thread, without locks.
+
+Push() never blocks or allocates, if the buffer is full the element is not added and Push() returns false. Each side
+only writes its own index, the other index is read with acquire ordering, so an element is fully written before the
+consumer can see it and fully read before the producer can reuse its slot.
+
+Usage:
+
+- Producer: Push(Element).
+- Consumer: Pop(aElements, iMaxCount) until it returns 0.
+
+*/// ----------------------------------------------------
+
+#include <atomic>
+#include <stddef.h>
+
+// ------------------------------------------------------
+
+template<typename T, unsigned int N>
+class SpscRing
+{
+	static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+private:
+
+	// The indexes only ever increase and wrap around, the slot is index & (N - 1).
+	// Both are on their own cache line, so the two threads don't invalidate each other's line on every push/pop.
+
+	alignas(64) std::atomic<unsigned int>
+				m_iHead { 0 }; // Next element to pop, written by the consumer
+
+	alignas(64) std::atomic<unsigned int>
+				m_iTail { 0 }; // Next slot to push to, written by the producer
+
+	alignas(64) T
+				m_aElements[N];
+
+public:
+
+	SpscRing()
+	{
+
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	// Producer only. Returns false if the buffer is full.
+	bool Push(const T& Element)
+	{
+		unsigned int
+			iTail = m_iTail.load(std::memory_order_relaxed);
+
+		if (iTail - m_iHead.load(std::memory_order_acquire) >= N)
+			return false;
+
+		m_aElements[iTail & (N - 1)] = Element;
+		m_iTail.store(iTail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// Consumer only. Copies up to iMaxCount elements to pElements, returns the number of elements copied.
+	size_t Pop(T* pElements, size_t iMaxCount)
+	{
+		unsigned int
+			iHead = m_iHead.load(std::memory_order_relaxed),
+			iCount = m_iTail.load(std::memory_order_acquire) - iHead;
+
+		if (iCount > iMaxCount)
+			iCount = (unsigned int)iMaxCount;
+
+		for (unsigned int i = 0; i < iCount; ++i)
+			pElements[i] = m_aElements[(iHead + i) & (N - 1)];
+
+		m_iHead.store(iHead + iCount, std::memory_order_release);
+
+		return iCount;
+	}
+};
+
+// ------------------------------------------------------
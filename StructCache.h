@@ -0,0 +1,229 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Struct Cache
+
+Binary image of a struct that was parsed from INI files, so later starts can skip parsing them.
+
+The image is keyed by the path, size, write time and content hash of every source file (including ones that didn't
+exist), the schema hash of the struct and the default values of T. Loading it is a single read plus a stat per
+source. Sources that were written shortly before the cache are also hashed again, because write times can be too
+coarse to show a change that happened in the same second.
+
+Usage:
+
+- Call Load() before parsing, if it returns true the target was filled and parsing can be skipped.
+- Otherwise parse as usual and pass the sources Load() returned to Save(). They describe the files as they were before
+  parsing, so a file that changes while it's being parsed can't end up in the cache with its new stamp.
+
+*/// ----------------------------------------------------
+
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "MappedFile.h"
+#include "FileWatcher.h"
+
+// ------------------------------------------------------
+
+namespace StructCache
+{
+	constexpr unsigned int MAGIC = 0x43434E44; // "DNCC"
+	constexpr unsigned int VERSION = 1;
+
+#if defined _WIN32
+	constexpr unsigned long long RACY_TIME = 2ULL * 10000000ULL; // 2 s, FILETIME is in 100 ns units
+#else
+	constexpr unsigned long long RACY_TIME = 2; // 2 s, st_mtime is in seconds
+#endif
+
+	struct SHeader
+	{
+		unsigned int
+					iMagic,
+					iVersion,
+					iSchemaHash,
+					iStructSize,
+					iSourceCount,
+					iReserved;
+
+		unsigned long long
+					iDefaultsHash,
+					iChecksum; // Of everything after the header
+	};
+
+	struct SSource
+	{
+		unsigned long long
+					iPathHash,
+					iSize,
+					iTime,
+					iContentHash;
+
+		unsigned int
+					bExists,
+					iReserved;
+	};
+
+	// 64 bit FNV-1a.
+	inline unsigned long long HashBytes(const void* pData, size_t iSize, unsigned long long iHash = 14695981039346656037ULL)
+	{
+		for (size_t i = 0; i < iSize; ++i)
+			iHash = (iHash ^ ((const unsigned char*)pData)[i]) * 1099511628211ULL;
+
+		return iHash;
+	}
+
+	// Sources are hashed when they may have just changed, so they are read instead of mapped (see MappedFile.h).
+	inline unsigned long long HashFile(const char* szFileName)
+	{
+		MappedFile
+			File;
+
+		if (!File.Read(szFileName))
+			return 0;
+
+		return HashBytes(File.GetData(), File.GetSize());
+	}
+
+	// Hash of a default constructed T, so changed defaults invalidate the cache. Padding is zeroed first.
+	template<typename T>
+	inline unsigned long long HashDefaults()
+	{
+		alignas(T) unsigned char
+			aDefaults[sizeof(T)] = {};
+
+		unsigned long long
+			iHash;
+
+		new (aDefaults) T;
+		iHash = HashBytes(aDefaults, sizeof(T));
+		((T*)aDefaults)->~T();
+
+		return iHash;
+	}
+
+	inline SSource MakeSource(const char* szFileName, const SFileStamp& Stamp)
+	{
+		SSource
+			Source = {};
+
+		Source.iPathHash = HashBytes(szFileName, strlen(szFileName));
+		Source.bExists = Stamp.bExists;
+		Source.iSize = Stamp.iSize;
+		Source.iTime = Stamp.iTime;
+		Source.iContentHash = Stamp.bExists ? HashFile(szFileName) : 0;
+
+		return Source;
+	}
+
+	inline void DescribeSources(const char* const* pszSources, size_t iSourceCount, std::vector<SSource>& vSources)
+	{
+		vSources.clear();
+
+		for (size_t i = 0; i < iSourceCount; ++i)
+			vSources.push_back(MakeSource(pszSources[i], GetFileStamp(pszSources[i])));
+	}
+
+	// Load() without describing the sources on a miss.
+	template<typename T>
+	bool _Load(const char* szCacheFile, const char* const* pszSources, size_t iSourceCount, unsigned int iSchemaHash, T* pTarget)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable structs can be cached");
+
+		MappedFile
+			File;
+
+		SHeader
+			Header;
+
+		SSource
+			Source;
+
+		SFileStamp
+			CacheStamp = GetFileStamp(szCacheFile),
+			Stamp;
+
+		const char
+			*pData;
+
+		if (!CacheStamp.bExists || !File.Open(szCacheFile) || File.GetSize() != sizeof(SHeader) + iSourceCount * sizeof(SSource) + sizeof(T))
+			return false;
+
+		pData = File.GetData();
+		memcpy(&Header, pData, sizeof(Header));
+		pData += sizeof(Header);
+
+		if (Header.iMagic != MAGIC || Header.iVersion != VERSION || Header.iSchemaHash != iSchemaHash || Header.iStructSize != sizeof(T) ||
+			Header.iSourceCount != iSourceCount || Header.iDefaultsHash != HashDefaults<T>() ||
+			Header.iChecksum != HashBytes(pData, File.GetSize() - sizeof(Header)))
+			return false;
+
+		for (size_t i = 0; i < iSourceCount; ++i, pData += sizeof(SSource))
+		{
+			memcpy(&Source, pData, sizeof(Source));
+			Stamp = GetFileStamp(pszSources[i]);
+
+			if (Source.iPathHash != HashBytes(pszSources[i], strlen(pszSources[i])) || Source.bExists != (unsigned int)Stamp.bExists ||
+				Source.iSize != Stamp.iSize || Source.iTime != Stamp.iTime)
+				return false;
+
+			// Changed within the resolution of the write time, only the content can tell
+
+			if (Stamp.bExists && Stamp.iTime + RACY_TIME >= CacheStamp.iTime && Source.iContentHash != HashFile(pszSources[i]))
+				return false;
+		}
+
+		memcpy(pTarget, pData, sizeof(T));
+
+		return true;
+	}
+
+	// Fills pTarget and returns true if the cache exists and all sources are unchanged.
+	// Otherwise vSources receives the current state of the sources for Save().
+	template<typename T>
+	bool Load(const char* szCacheFile, const char* const* pszSources, size_t iSourceCount, unsigned int iSchemaHash, T* pTarget,
+		std::vector<SSource>& vSources)
+	{
+		if (_Load(szCacheFile, pszSources, iSourceCount, iSchemaHash, pTarget))
+			return true;
+
+		DescribeSources(pszSources, iSourceCount, vSources);
+		return false;
+	}
+
+	// vSources: As returned by Load(). Returns false if the cache couldn't be written.
+	template<typename T>
+	bool Save(const char* szCacheFile, const std::vector<SSource>& vSources, unsigned int iSchemaHash, const T* pSource)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable structs can be cached");
+
+		SHeader
+			Header = {};
+
+		std::vector<unsigned char>
+			vData(sizeof(SHeader));
+
+		for (auto &Source : vSources)
+			vData.insert(vData.end(), (const unsigned char*)&Source, (const unsigned char*)&Source + sizeof(Source));
+
+		vData.insert(vData.end(), (const unsigned char*)pSource, (const unsigned char*)pSource + sizeof(T));
+
+		Header.iMagic = MAGIC;
+		Header.iVersion = VERSION;
+		Header.iSchemaHash = iSchemaHash;
+		Header.iStructSize = sizeof(T);
+		Header.iSourceCount = (unsigned int)vSources.size();
+		Header.iDefaultsHash = HashDefaults<T>();
+		Header.iChecksum = HashBytes(vData.data() + sizeof(SHeader), vData.size() - sizeof(SHeader));
+
+		memcpy(vData.data(), &Header, sizeof(Header));
+
+		return WriteFileAtomic(szCacheFile, vData.data(), vData.size());
+	}
+}
+
+// ------------------------------------------------------
@@ -6,7 +6,20 @@ Struct Parser
 
 Parses an INI file into a struct.
 
-Usage:
+Usage with a static schema (preferred):
+
+- Declare the schema as static constexpr with MakeStructSchema<T>() and one STRUCT_FIELD for every value you want to parse.
+  Types, sizes and offsets are deduced from the members at compile time and the lookup table is built by the compiler.
+- Create a StructParser from the schema. This doesn't allocate anything.
+
+	static constexpr auto Schema = MakeStructSchema<SConfig>({
+		STRUCT_FIELD(SConfig, bActive, "General", "Active"),
+		STRUCT_FIELD(SConfig, iSwapDelay, "General", "SwapDelay")
+	});
+
+	StructParser<SConfig> Parser(Schema);
+
+Usage with runtime links:
 
 - Create a new object of the type of struct you want to parse data into. This is not the object the data goes into, it's just used to calculate offsets.
 - Create a new instance of the StructParser class using the template for the desired struct.
@@ -16,6 +29,21 @@ Usage:
 To actually parse the data:
 
 - Call Parse/ParseFile on the object you want to parse the data into. The source can be a file or data in memory.
+- Or parse it into a StructDocument once and Apply() that to as many objects as needed. Parsing several sources into
+  the same document merges them, values from later sources win.
+- Very large sources can be parsed with ParseParallel(), which splits them at section headers and parses the parts
+  on separate threads. The result is the same as with Parse().
+- Update() writes the values of a struct back into an INI file. Only values that differ are patched, everything else
+  (comments, order, formatting) stays as it is. Missing keys are added to their section.
+- Data that arrives in pieces (pipes, sockets, fixed-size read buffers) can be pushed through a StructStream, which
+  keeps the partial line and the current section between chunks in fixed-size buffers.
+
+Numeric and BOOL members with more than one index take a list of values separated by commas and/or spaces, ie.
+"ModelIDs = 400, 401 402". Elements after the last value are set to 0, more values than indexes is a RANGE error.
+
+Keys are looked up through a hash table of (section, key), so the cost of a line does not depend on the amount of links.
+Parsing works on views into the source and does not modify it or allocate memory per line.
+Values that can't be converted or don't fit are skipped and counted, see GetErrorCount()/GetLastError().
 
 IMPORTANT:
 	The object used as base is not the target of the data being parsed. It is only used to calculate offsets for the values.
@@ -26,8 +54,28 @@ IMPORTANT:
 */// ----------------------------------------------------
 
 #include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <charconv>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "MappedFile.h"
+
+#if !defined DNC_NO_SIMD && (defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2))
+#define STRUCT_PARSER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
+
 // ------------------------------------------------------
 
 namespace LinkType
@@ -36,417 +84,1982 @@ namespace LinkType
 	{
 		SIGNED = 0, // Signed value of any size
 		UNSIGNED, // Unsigned value of any size
-		BOOL = UNSIGNED, // Included for clarity
 		FLOAT, // Floating point value, ie float or double
 		STRING, // Zero terminated char array
+		BOOL, // true/false, yes/no, on/off or 1/0 into a value of any size
 
 		MAX
 	};
 }
 
-// ------------------------------------------------------
-
-template<typename T>
-class StructParser
+namespace ParseError
 {
-private:
-
-	struct StructLink
+	enum
 	{
-		int		iType = -1;
-		size_t	iElementSize = 0;
-		size_t	iIndexes = 0;
+		NONE = 0,
+		FORMAT, // Not a valid value for the link type
+		RANGE, // Valid, but doesn't fit into the target (or too many values for an array)
+		LENGTH, // Line doesn't fit into the StructStream buffer
 
-		size_t	iOffset = 0;
-
-		char	*pSection = nullptr;
-		char	*pKey = nullptr;
+		MAX
 	};
+}
 
-	T*			m_pBase;
+// ------------------------------------------------------
 
-	std::vector<StructLink*>
-				m_vLinks;
+// Locale independent value conversion, used by StructParser.
+// All functions take the whole text (without padding), return a ParseError:: code and only write the target on success.
 
-	bool _CmpStr(const char* szText1, const char* szText2, bool bIgnoreCase)
+namespace StructValue
+{
+	inline bool EqualsNoCase(std::string_view Text1, std::string_view Text2)
 	{
-		size_t
-			iLen1 = strlen(szText1),
-			iLen2 = strlen(szText2);
-
-		if (iLen1 != iLen2)
+		if (Text1.size() != Text2.size())
 			return false;
 
-		if (bIgnoreCase)
-		{
-			for (size_t i = 0; i < iLen1; ++i)
-				if (tolower((int)szText1[i]) != tolower((int)szText2[i]))
-					return false;
-		}
-		else
-		{
-			for (size_t i = 0; i < iLen1; ++i)
-				if (szText1[i] != szText2[i])
-					return false;
-		}
+		for (size_t i = 0; i < Text1.size(); ++i)
+			if (tolower((int)(unsigned char)Text1[i]) != tolower((int)(unsigned char)Text2[i]))
+				return false;
 
 		return true;
 	}
 
-	size_t _RemovePadding(char* szText)
+	// Optional sign, then decimal or 0x prefixed hexadecimal digits.
+	inline int DecodeInteger(std::string_view Text, bool bSigned, size_t iElementSize, void* pTarget)
 	{
-		size_t
-			iLen = strlen(szText),
-			iLenNew,
-			iFirstChar = iLen,
-			iLastChar = iLen;
+		unsigned long long
+			iMagnitude = 0,
+			iMax;
 
-		for (size_t i = 0; i < iLen; ++i)
-		{
-			if (szText[i] != ' ')
-			{
-				if (iFirstChar == iLen)
-					iFirstChar = i;
+		bool
+			bNegative = false;
 
-				iLastChar = i;
-			}
+		int
+			iBase = 10;
+
+		std::from_chars_result
+			Result;
+
+		if (iElementSize != 1 && iElementSize != 2 && iElementSize != 4 && iElementSize != 8)
+			return ParseError::FORMAT;
+
+		if (!Text.empty() && (Text[0] == '-' || Text[0] == '+'))
+		{
+			bNegative = Text[0] == '-';
+			Text.remove_prefix(1);
 		}
 
-		if (iFirstChar == iLen)
+		if (Text.size() > 2 && Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
 		{
-			szText[0] = 0;
-			return 0;
+			iBase = 16;
+			Text.remove_prefix(2);
 		}
-		else if (iFirstChar == iLastChar)
+
+		if (Text.empty())
+			return ParseError::FORMAT;
+
+		Result = std::from_chars(Text.data(), Text.data() + Text.size(), iMagnitude, iBase);
+
+		if (Result.ec == std::errc::result_out_of_range)
+			return ParseError::RANGE;
+
+		if (Result.ec != std::errc() || Result.ptr != Text.data() + Text.size())
+			return ParseError::FORMAT;
+
+		// Largest magnitude for the size, for negative values it's one more than the positive maximum
+
+		iMax = iElementSize == 8 ? ~0ULL : (1ULL << (iElementSize * 8)) - 1;
+
+		if (bSigned)
+			iMax = (iMax >> 1) + (bNegative ? 1 : 0);
+		else if (bNegative && iMagnitude != 0)
+			return ParseError::RANGE;
+
+		if (iMagnitude > iMax)
+			return ParseError::RANGE;
+
+		if (bNegative)
+			iMagnitude = 0ULL - iMagnitude;
+
+		// Truncating the two's complement value gives the right result for every size
+
+		switch (iElementSize)
 		{
-			szText[0] = szText[iFirstChar];
-			szText[1] = 0;
-			return 1;
+		case 1: *(unsigned char*)pTarget = (unsigned char)iMagnitude; break;
+		case 2: *(unsigned short*)pTarget = (unsigned short)iMagnitude; break;
+		case 4: *(unsigned int*)pTarget = (unsigned int)iMagnitude; break;
+		case 8: *(unsigned long long*)pTarget = iMagnitude; break;
 		}
 
-		iLenNew = iLastChar - iFirstChar + 1;
+		return ParseError::NONE;
+	}
+
+	inline int DecodeFloat(std::string_view Text, size_t iElementSize, void* pTarget)
+	{
+		std::from_chars_result
+			Result;
+
+		float
+			fValue;
+
+		double
+			dValue;
+
+		if (!Text.empty() && Text[0] == '+')
+			Text.remove_prefix(1);
+
+		if (iElementSize == 4)
+			Result = std::from_chars(Text.data(), Text.data() + Text.size(), fValue);
+		else if (iElementSize == 8)
+			Result = std::from_chars(Text.data(), Text.data() + Text.size(), dValue);
+		else
+			return ParseError::FORMAT;
+
+		if (Result.ec == std::errc::result_out_of_range)
+			return ParseError::RANGE;
 
-		memmove(szText, szText + iFirstChar, iLenNew);
-		szText[iLenNew] = 0;
+		if (Result.ec != std::errc() || Result.ptr != Text.data() + Text.size() || Text.empty())
+			return ParseError::FORMAT;
+
+		if (iElementSize == 4)
+			*(float*)pTarget = fValue;
+		else
+			*(double*)pTarget = dValue;
 
-		return iLenNew;
+		return ParseError::NONE;
 	}
 
-public:
+	inline int DecodeBool(std::string_view Text, size_t iElementSize, void* pTarget)
+	{
+		unsigned char
+			bValue;
 
-	StructParser(T* pBase = nullptr) :
-		m_pBase(pBase)
+		if (Text == "1" || EqualsNoCase(Text, "true") || EqualsNoCase(Text, "yes") || EqualsNoCase(Text, "on"))
+			bValue = 1;
+		else if (Text == "0" || EqualsNoCase(Text, "false") || EqualsNoCase(Text, "no") || EqualsNoCase(Text, "off"))
+			bValue = 0;
+		else
+			return ParseError::FORMAT;
+
+		return DecodeInteger(bValue ? "1" : "0", false, iElementSize, pTarget);
+	}
+
+	// Copies up to the first tab, truncated to iIndexes - 1 characters (unless iIndexes is 0) and terminated.
+	inline int DecodeString(std::string_view Text, size_t iElementSize, size_t iIndexes, void* pTarget)
 	{
+		size_t
+			iSize = std::min(Text.find('\t'), Text.size());
+
+		if (iElementSize != 1)
+			return ParseError::FORMAT;
+
+		if (iIndexes != 0 && iSize > iIndexes - 1)
+			iSize = iIndexes - 1;
+
+		memcpy(pTarget, Text.data(), iSize);
+		((char*)pTarget)[iSize] = 0;
 
+		return ParseError::NONE;
 	}
 
-	~StructParser()
+	inline bool IsListDelimiter(char c)
 	{
-		ResetLinks();
+		return c == ',' || c == ' ' || c == '\t';
 	}
 
-	void SetBase(T* pBase = nullptr)
+	inline unsigned int LowestBit(unsigned int iMask)
 	{
-		m_pBase = pBase;
+#if defined _MSC_VER
+		unsigned long
+			iIndex;
+
+		_BitScanForward(&iIndex, iMask);
+		return (unsigned int)iIndex;
+#else
+		return (unsigned int)__builtin_ctz(iMask);
+#endif
 	}
 
-	// iType: See LinkType::
-	// iElementSize: Size of one element in bytes ie. sizeof(type). Supported sizes: 1, 2, 4, 8
-	// iIndexes: The amount of indexes. If the array size is unknown you can use 0, however this is only safe for properly
-	//   terminated char strings that are guaranteed to fit.
-	// pTarget: Target variable within the base struct.
-	// szSection: Name of the INI section.
-	// szKey: Name of the INI key.
-	bool Link(int iType, void* pTarget, size_t iElementSize, size_t iIndexes, const char* szSection, const char* szKey)
+	// First list delimiter in [pText, pEnd), or pEnd. Checks 16 characters at a time with SSE2.
+	inline const char* FindListDelimiter(const char* pText, const char* pEnd)
 	{
-		StructLink
-			*pLink;
+#if defined STRUCT_PARSER_SSE2
+		const __m128i
+			vComma = _mm_set1_epi8(','),
+			vSpace = _mm_set1_epi8(' '),
+			vTab = _mm_set1_epi8('\t');
 
-		size_t
-			iLen,
-			iOffset;
+		__m128i
+			vChars;
 
-		if (iType < 0 || iType >= LinkType::MAX || !m_pBase || (size_t)(void*)pTarget < (size_t)(void*)m_pBase)
-			return false;
+		unsigned int
+			iMask;
 
-		iOffset = (size_t)(void*)pTarget - (size_t)(void*)m_pBase;
+		for (; pEnd - pText >= 16; pText += 16)
+		{
+			vChars = _mm_loadu_si128((const __m128i*)pText);
+			iMask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(vChars, vComma), _mm_cmpeq_epi8(vChars, vSpace)), _mm_cmpeq_epi8(vChars, vTab)));
 
-		if (iOffset + iElementSize * (iIndexes == 0 ? 1 : iIndexes) >= sizeof(T))
-			return false;
+			if (iMask)
+				return pText + LowestBit(iMask);
+		}
+#endif
 
-		pLink = new StructLink;
+		while (pText < pEnd && !IsListDelimiter(*pText))
+			++pText;
 
-		pLink->iType = iType;
-		pLink->iElementSize = iElementSize;
-		pLink->iIndexes = iIndexes;
+		return pText;
+	}
 
-		pLink->iOffset = iOffset;
+	// Value of a plain decimal number with an optional '-' and up to 18 digits, which can't overflow.
+	// Returns false for anything else, so the caller can fall back to DecodeInteger().
+	inline bool DecodeDecimalFast(std::string_view Text, long long& iValue)
+	{
+		bool
+			bNegative = !Text.empty() && Text[0] == '-';
 
-		iLen = strlen(szSection) + 1;
-		pLink->pSection = new char[iLen];
-		memcpy(pLink->pSection, szSection, iLen);
+		unsigned long long
+			iMagnitude = 0;
 
-		iLen = strlen(szKey) + 1;
-		pLink->pKey = new char[iLen];
-		memcpy(pLink->pKey, szKey, iLen);
+		if (bNegative)
+			Text.remove_prefix(1);
+
+		if (Text.empty() || Text.size() > 18)
+			return false;
+
+		for (char c : Text)
+		{
+			if (c < '0' || c > '9')
+				return false;
 
-		m_vLinks.push_back(pLink);
+			iMagnitude = iMagnitude * 10 + (unsigned long long)(c - '0');
+		}
 
+		iValue = bNegative ? -(long long)iMagnitude : (long long)iMagnitude;
 		return true;
 	}
 
-	void ResetLinks()
+	template<typename E>
+	inline void StoreIntegers(const long long* pValues, size_t iCount, void* pTarget)
 	{
-		for (auto &p : m_vLinks)
-		{
-			delete[] p->pSection;
-			delete[] p->pKey;
-			delete p;
-		}
-
-		m_vLinks.clear();
+		for (size_t i = 0; i < iCount; ++i)
+			((E*)pTarget)[i] = (E)pValues[i];
 	}
 
-	int ParseFile(const char* szFileName, T* pTarget, bool bIgnoreCase = true)
+	// Converts a list of integers one token at a time: plain decimals with DecodeDecimalFast() and an inline range
+	// check, everything else with DecodeInteger(). Only the stores are batched, the values are collected into a buffer
+	// and written with one loop per element size instead of switching on the size for every value.
+	inline int DecodeIntegerList(std::string_view Text, bool bSigned, size_t iElementSize, size_t iIndexes, void* pTarget, size_t* pCount)
 	{
-		FILE
-			*pFile;
+		constexpr size_t
+			BATCH_SIZE = 64;
 
-		char
-			*pData;
+		long long
+			aValues[BATCH_SIZE],
+			iMin,
+			iMax;
 
 		size_t
-			iLen;
+			iBatch = 0,
+			iCount = 0;
+
+		const char
+			*pText = Text.data(),
+			*pEnd = Text.data() + Text.size(),
+			*pToken;
+
+		std::string_view
+			Token;
 
 		int
-			iParsedValues;
+			iResult;
 
-		if (fopen_s(&pFile, szFileName, "r"))
-			return -1;
+		if (iElementSize != 1 && iElementSize != 2 && iElementSize != 4 && iElementSize != 8)
+			return ParseError::FORMAT;
 
-#if _WIN64
-		_fseeki64(pFile, 0, SEEK_END);
-		iLen = (size_t)_ftelli64(pFile);
-		_fseeki64(pFile, 0, SEEK_SET);
-#else
-		fseek(pFile, 0, SEEK_END);
-		iLen = (size_t)ftell(pFile);
-		fseek(pFile, 0, SEEK_SET);
-#endif
+		// Range of the fast path, 8 byte values always go through DecodeInteger()
 
-		pData = new char[iLen + 1U];
-		pData[iLen] = 0;
+		iMin = iElementSize == 8 ? 0 : (bSigned ? -(1LL << (iElementSize * 8 - 1)) : 0);
+		iMax = iElementSize == 8 ? 0 : (bSigned ? (1LL << (iElementSize * 8 - 1)) - 1 : (1LL << (iElementSize * 8)) - 1);
 
-		fread(pData, sizeof(char), iLen, pFile);
-		fclose(pFile);
+		auto fnStoreBatch = [&]()
+		{
+			char
+				*pBatchTarget = (char*)pTarget + (iCount - iBatch) * iElementSize;
+
+			switch (iElementSize)
+			{
+			case 1: StoreIntegers<unsigned char>(aValues, iBatch, pBatchTarget); break;
+			case 2: StoreIntegers<unsigned short>(aValues, iBatch, pBatchTarget); break;
+			case 4: StoreIntegers<unsigned int>(aValues, iBatch, pBatchTarget); break;
+			case 8: StoreIntegers<unsigned long long>(aValues, iBatch, pBatchTarget); break;
+			}
+
+			iBatch = 0;
+		};
+
+		while (pText < pEnd)
+		{
+			if (IsListDelimiter(*pText))
+			{
+				++pText;
+				continue;
+			}
 
-		iParsedValues = Parse(pData, pTarget, bIgnoreCase, iLen);
+			pToken = pText;
+			pText = FindListDelimiter(pText, pEnd);
+			Token = std::string_view(pToken, pText - pToken);
 
-		delete[] pData;
+			if (iCount == iIndexes)
+				return ParseError::RANGE;
 
-		return iParsedValues;
+			if (iElementSize == 8 || !DecodeDecimalFast(Token, aValues[iBatch]))
+			{
+				if (EqualsNoCase(Token, "true"))
+					Token = "1";
+				else if (EqualsNoCase(Token, "false"))
+					Token = "0";
+
+				aValues[iBatch] = 0;
+				iResult = DecodeInteger(Token, bSigned, iElementSize, &aValues[iBatch]);
+
+				if (iResult != ParseError::NONE)
+					return iResult;
+
+				// Sign extend, so the value is the same as from the fast path
+
+				if (bSigned && iElementSize < 8 && (aValues[iBatch] >> (iElementSize * 8 - 1)) & 1)
+					aValues[iBatch] |= (long long)(~0ULL << (iElementSize * 8));
+			}
+			else if (aValues[iBatch] < iMin || aValues[iBatch] > iMax)
+			{
+				return ParseError::RANGE;
+			}
+
+			++iBatch;
+			++iCount;
+
+			if (iBatch == BATCH_SIZE)
+				fnStoreBatch();
+		}
+
+		fnStoreBatch();
+
+		*pCount = iCount;
+
+		return iCount ? ParseError::NONE : ParseError::FORMAT;
 	}
 
-	int Parse(char* pSource, T* pTarget, bool bIgnoreCase = true, size_t iSourceLen = 0)
+	// Decodes a single value.
+	inline int DecodeOne(int iType, size_t iElementSize, size_t iIndexes, std::string_view Text, void* pTarget)
 	{
-		char
-			*pLine = nullptr,
-			*pSection = nullptr;
+		// Numbers also accept true/false for compatibility with configs from before BOOL was its own type
 
-		int
-			iParsedValues = 0;
+		switch (iType)
+		{
+		case LinkType::SIGNED:
+		case LinkType::UNSIGNED:
+
+			if (EqualsNoCase(Text, "true"))
+				Text = "1";
+			else if (EqualsNoCase(Text, "false"))
+				Text = "0";
+
+			return DecodeInteger(Text, iType == LinkType::SIGNED, iElementSize, pTarget);
+
+		case LinkType::FLOAT:
+			return DecodeFloat(Text, iElementSize, pTarget);
+
+		case LinkType::BOOL:
+			return DecodeBool(Text, iElementSize, pTarget);
+
+		case LinkType::STRING:
+			return DecodeString(Text, iElementSize, iIndexes, pTarget);
+		}
+
+		return ParseError::FORMAT;
+	}
+
+	// Decodes a list of up to iIndexes values into consecutive elements, see IsListDelimiter().
+	// Unlike the other functions this may have written some elements if it fails.
+	inline int DecodeList(int iType, size_t iElementSize, size_t iIndexes, std::string_view Text, void* pTarget, size_t* pCount)
+	{
+		const char
+			*pText = Text.data(),
+			*pEnd = Text.data() + Text.size(),
+			*pToken;
 
 		size_t
-			iLen = (iSourceLen == 0 ? strlen(pSource) : iSourceLen),
-			iLineStart = 0,
-			iLineLen = 0,
-			iTmpLen;
+			iCount = 0;
 
-		if (!iLen)
-			return -1;
+		int
+			iResult;
 
-		for (size_t i = 0; i <= iLen; ++i)
+		if (iType == LinkType::SIGNED || iType == LinkType::UNSIGNED)
+			return DecodeIntegerList(Text, iType == LinkType::SIGNED, iElementSize, iIndexes, pTarget, pCount);
+
+		while (pText < pEnd)
 		{
-			if (i == iLen || pSource[i] == '\r' || pSource[i] == '\n' || pSource[i] == 0)
+			if (IsListDelimiter(*pText))
 			{
-				if (iLineLen < 2)
-				{
-					iLineStart = i + 1;
-					iLineLen = 0;
-					continue;
-				}
+				++pText;
+				continue;
+			}
 
-				// Free previous line
+			pToken = pText;
+			pText = FindListDelimiter(pText, pEnd);
 
-				if (pLine)
-				{
-					delete[] pLine;
-					pLine = nullptr;
-				}
+			if (iCount == iIndexes)
+				return ParseError::RANGE;
 
-				// Allocate a new line and fill it
+			iResult = DecodeOne(iType, iElementSize, 1, std::string_view(pToken, pText - pToken), (char*)pTarget + iCount * iElementSize);
 
-				pLine = new char[iLineLen + 1];
-				memcpy(pLine, pSource + iLineStart, iLineLen);
-				pLine[iLineLen] = 0;
+			if (iResult != ParseError::NONE)
+				return iResult;
 
-				// Reset line counter
+			++iCount;
+		}
 
-				iLineStart = i + 1;
-				iLineLen = 0;
+		*pCount = iCount;
 
-				// Remove padding and check remaining length
+		return iCount ? ParseError::NONE : ParseError::FORMAT;
+	}
 
-				iTmpLen = _RemovePadding(pLine);
+	// Strings and single values are decoded as a whole, numeric and BOOL arrays as a list (see DecodeList()).
+	// pWritten (optional) receives the amount of bytes written from the start of pTarget on success.
+	inline int Decode(int iType, size_t iElementSize, size_t iIndexes, std::string_view Text, void* pTarget, size_t* pWritten = nullptr)
+	{
+		int
+			iResult;
 
-				if (iTmpLen < 2)
-					continue;
+		size_t
+			iCount = 1;
 
-				if (pLine[0] == '[' && pLine[iTmpLen - 1] == ']')
-				{
-					// If this is a section copy the pointer to the section pointer and delete the old one (if any)
+		if (iType != LinkType::STRING && iIndexes > 1)
+			iResult = DecodeList(iType, iElementSize, iIndexes, Text, pTarget, &iCount);
+		else
+			iResult = DecodeOne(iType, iElementSize, iIndexes, Text, pTarget);
 
-					pLine[0] = ' ';
-					pLine[iTmpLen - 1] = ' ';
+		if (iResult == ParseError::NONE && pWritten)
+			*pWritten = iType == LinkType::STRING ? strlen((const char*)pTarget) + 1 : iElementSize * iCount;
 
-					if (pSection)
-						delete[] pSection;
+		return iResult;
+	}
 
-					// After removing [ and ] make sure there is text left, otherwise reset the section
+	inline unsigned long long LoadUnsigned(const void* pValue, size_t iElementSize)
+	{
+		switch (iElementSize)
+		{
+		case 1: return *(const unsigned char*)pValue;
+		case 2: return *(const unsigned short*)pValue;
+		case 4: return *(const unsigned int*)pValue;
+		case 8: return *(const unsigned long long*)pValue;
+		}
 
-					if (_RemovePadding(pLine))
-					{
-						pSection = pLine;
-						pLine = nullptr;
-					}
-					else
-					{
-						pSection = nullptr;
-					}
-				}
-				else
-				{
-					// If this is a value, parse it
+		return 0;
+	}
 
-					if (ParseValue(pSection, pLine, pTarget, bIgnoreCase))
-						++iParsedValues;
-				}
-			}
-			else
-			{
-				++iLineLen;
-			}
+	inline long long LoadSigned(const void* pValue, size_t iElementSize)
+	{
+		switch (iElementSize)
+		{
+		case 1: return *(const signed char*)pValue;
+		case 2: return *(const short*)pValue;
+		case 4: return *(const int*)pValue;
+		case 8: return *(const long long*)pValue;
 		}
 
-		// Clean up
+		return 0;
+	}
 
-		if (pSection)
-			delete[] pSection;
+	// Amount of list elements that are written by Encode(), trailing elements that are 0 are left out.
+	inline size_t ListCount(size_t iElementSize, size_t iIndexes, const void* pValue)
+	{
+		size_t
+			iCount = iIndexes;
 
-		if(pLine)
-			delete[] pLine;
+		while (iCount > 1 && LoadUnsigned((const char*)pValue + (iCount - 1) * iElementSize, iElementSize == 8 || iElementSize == 4 || iElementSize == 2 ? iElementSize : 1) == 0)
+			--iCount;
 
-		return iParsedValues;
+		return iCount;
+	}
+
+	// Bytes that Decode() writes for the text Encode() creates for the value, used to compare values.
+	inline size_t EncodedSize(int iType, size_t iElementSize, size_t iIndexes, const void* pValue)
+	{
+		if (iType == LinkType::STRING)
+			return strnlen((const char*)pValue, iIndexes ? iIndexes - 1 : (size_t)-1) + 1;
+
+		if (iIndexes > 1)
+			return iElementSize * ListCount(iElementSize, iIndexes, pValue);
+
+		return iElementSize;
 	}
 
-	bool ParseValue(char* pSection, char* pLine, T* pTarget, bool bIgnoreCase)
+	inline void EncodeOne(int iType, size_t iElementSize, const void* pValue, std::string& Text)
 	{
 		char
-			*pKey,
-			*pValue,
-			*pContext;
+			aBuffer[64];
 
-		size_t
-			iSize;
+		std::to_chars_result
+			Result = { aBuffer, std::errc() };
 
-		size_t
-			iPointer;
+		switch (iType)
+		{
+		case LinkType::SIGNED:
+			Result = std::to_chars(aBuffer, aBuffer + sizeof(aBuffer), LoadSigned(pValue, iElementSize));
+			break;
 
-		pKey = strtok_s(pLine, "=", &pContext);
+		case LinkType::UNSIGNED:
+			Result = std::to_chars(aBuffer, aBuffer + sizeof(aBuffer), LoadUnsigned(pValue, iElementSize));
+			break;
 
-		if (!pKey || !_RemovePadding(pKey))
-			return false;
+		case LinkType::FLOAT:
 
-		pValue = strtok_s(nullptr, "=", &pContext);
+			// Shortest text that reads back as the same value
 
-		if (!pValue || !_RemovePadding(pValue))
-			return false;
+			if (iElementSize == 4)
+				Result = std::to_chars(aBuffer, aBuffer + sizeof(aBuffer), *(const float*)pValue);
+			else if (iElementSize == 8)
+				Result = std::to_chars(aBuffer, aBuffer + sizeof(aBuffer), *(const double*)pValue);
 
-		if (_CmpStr(pValue, "true", true))
-		{
-			pValue[0] = 0;
-			strcat_s(pValue, 2, "1");
+			break;
+
+		case LinkType::BOOL:
+			Text.append(LoadUnsigned(pValue, iElementSize) ? "true" : "false");
+			return;
 		}
-		else if (_CmpStr(pValue, "false", true))
+
+		if (Result.ec == std::errc())
+			Text.append(aBuffer, Result.ptr - aBuffer);
+	}
+
+	// Appends the text of a value. Lists are separated by ", " and written up to the last element that isn't 0.
+	inline void Encode(int iType, size_t iElementSize, size_t iIndexes, const void* pValue, std::string& Text)
+	{
+		size_t
+			iCount;
+
+		if (iType == LinkType::STRING)
 		{
-			pValue[0] = 0;
-			strcat_s(pValue, 2, "0");
+			Text.append((const char*)pValue, EncodedSize(iType, iElementSize, iIndexes, pValue) - 1);
+			return;
 		}
 
-		for (auto &pLink : m_vLinks)
+		iCount = iIndexes > 1 ? ListCount(iElementSize, iIndexes, pValue) : 1;
+
+		for (size_t i = 0; i < iCount; ++i)
 		{
-			// Check if the current value and link have either no section, or the same section
-			// and if the keys match.
+			if (i)
+				Text.append(", ");
 
-			if (((!pSection && !pLink->pSection) || (pSection && _CmpStr(pSection, pLink->pSection, bIgnoreCase))) &&
-				_CmpStr(pKey, pLink->pKey, bIgnoreCase)
-				)
-			{
-				iPointer = (size_t)pTarget + pLink->iOffset;
+			EncodeOne(iType, iElementSize, (const char*)pValue + i * iElementSize, Text);
+		}
+	}
+}
 
-				switch (pLink->iType)
-				{
-				case LinkType::SIGNED:
+// ------------------------------------------------------
+
+// Case-insensitive FNV-1a hash of a section and key, used to look up links.
+// constexpr so tables can be built at compile time.
+
+namespace StructHash
+{
+	constexpr unsigned int BASIS = 2166136261U;
+	constexpr unsigned int PRIME = 16777619U;
+
+	constexpr char ToLower(char c)
+	{
+		return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+	}
+
+	// Hashes iLen characters, or up to the terminator if iLen is (size_t)-1.
+	constexpr unsigned int Append(unsigned int iHash, const char* szText, size_t iLen = (size_t)-1)
+	{
+		for (size_t i = 0; szText && i < iLen && szText[i]; ++i)
+			iHash = (iHash ^ (unsigned char)ToLower(szText[i])) * PRIME;
 
-					if (pLink->iElementSize == 1)
-						sscanf_s(pValue, "%hhi", (__int8*)iPointer);
-					else if (pLink->iElementSize == 2)
-						sscanf_s(pValue, "%hi", (__int16*)iPointer);
-					else if (pLink->iElementSize == 4)
-						sscanf_s(pValue, "%i", (__int32*)iPointer);
-					else if (pLink->iElementSize == 8)
-						sscanf_s(pValue, "%lli", (__int64*)iPointer);
+		return iHash;
+	}
+
+	constexpr unsigned int Key(const char* szSection, size_t iSectionLen, const char* szKey, size_t iKeyLen)
+	{
+		// 0xFF separates section and key so ("ab", "c") and ("a", "bc") don't collide
 
-					break;
+		return Append((Append(BASIS, szSection, iSectionLen) ^ 0xFFU) * PRIME, szKey, iKeyLen);
+	}
 
-				case LinkType::UNSIGNED:
+	constexpr unsigned int Key(const char* szSection, const char* szKey)
+	{
+		return Key(szSection, (size_t)-1, szKey, (size_t)-1);
+	}
 
-					if (pLink->iElementSize == 1)
-						sscanf_s(pValue, "%hhu", (unsigned __int8*)iPointer);
-					else if (pLink->iElementSize == 2)
-						sscanf_s(pValue, "%hu", (unsigned __int16*)iPointer);
-					else if (pLink->iElementSize == 4)
-						sscanf_s(pValue, "%u", (unsigned __int32*)iPointer);
-					else if (pLink->iElementSize == 8)
-						sscanf_s(pValue, "%llu", (unsigned __int64*)iPointer);
+	// Adds the bytes of a number, independent of the size of size_t.
+	constexpr unsigned int Mix(unsigned int iHash, unsigned long long iValue)
+	{
+		for (int i = 0; i < 8; ++i)
+			iHash = (iHash ^ (unsigned int)((iValue >> (i * 8)) & 0xFF)) * PRIME;
 
-					break;
+		return iHash;
+	}
+}
 
-				case LinkType::FLOAT:
+// ------------------------------------------------------
 
-					if (pLink->iElementSize == 4)
-						sscanf_s(pValue, "%f", (float*)iPointer);
-					else if (pLink->iElementSize == 8)
-						sscanf_s(pValue, "%lf", (double*)iPointer);
+// One struct member that is read from an INI key.
 
-					break;
+struct StructLink
+{
+	int		iType = -1;
+	size_t	iElementSize = 0;
+	size_t	iIndexes = 0;
 
-				case LinkType::STRING:
+	size_t	iOffset = 0;
 
-					if (pLink->iIndexes == 0)
-						iSize = strlen(pValue);
-					else
-						iSize = pLink->iIndexes;
+	const char
+			*pSection = nullptr,
+			*pKey = nullptr;
 
-					if (pLink->iElementSize == 1)
-						sscanf_s(pValue, "%[^\t\n]", (char*)iPointer, (unsigned int)iSize);
+	unsigned int
+			iHash = 0;
+};
 
-					break;
-				}
-			}
-		}
+// Open addressing hash table of link indexes, -1 = empty.
 
-		return true;
+namespace StructTable
+{
+	// Power of two, at least twice the amount of links
+	constexpr size_t Size(size_t iLinkCount)
+	{
+		size_t
+			iSize = 16;
+
+		while (iSize < iLinkCount * 2)
+			iSize *= 2;
+
+		return iSize;
+	}
+
+	constexpr void Build(const StructLink* pLinks, size_t iLinkCount, int* pTable, size_t iTableSize)
+	{
+		size_t
+			iSlot = 0;
+
+		for (size_t i = 0; i < iTableSize; ++i)
+			pTable[i] = -1;
+
+		for (size_t i = 0; i < iLinkCount; ++i)
+		{
+			iSlot = pLinks[i].iHash & (iTableSize - 1);
+
+			while (pTable[iSlot] != -1)
+				iSlot = (iSlot + 1) & (iTableSize - 1);
+
+			pTable[iSlot] = (int)i;
+		}
+	}
+}
+
+// ------------------------------------------------------
+
+// Creates a link for a member of type M, the link type and sizes are deduced from M.
+// Use STRUCT_FIELD instead of calling this directly.
+template<typename M>
+constexpr StructLink MakeStructLink(size_t iOffset, const char* szSection, const char* szKey)
+{
+	using E = std::remove_extent_t<M>;
+
+	StructLink
+		Link;
+
+	static_assert(std::rank_v<M> <= 1, "Only one-dimensional arrays can be linked");
+	static_assert(std::is_arithmetic_v<E>, "Only arithmetic types, arrays of them and char arrays can be linked");
+	static_assert(sizeof(E) == 1 || sizeof(E) == 2 || sizeof(E) == 4 || sizeof(E) == 8, "Unsupported element size");
+	static_assert(!std::is_floating_point_v<E> || sizeof(E) == 4 || sizeof(E) == 8, "Unsupported floating point size");
+
+	if constexpr (std::is_same_v<E, bool>)
+		Link.iType = LinkType::BOOL;
+	else if constexpr (std::is_same_v<E, char> && std::is_array_v<M>)
+		Link.iType = LinkType::STRING;
+	else if constexpr (std::is_floating_point_v<E>)
+		Link.iType = LinkType::FLOAT;
+	else if constexpr (std::is_signed_v<E>)
+		Link.iType = LinkType::SIGNED;
+	else
+		Link.iType = LinkType::UNSIGNED;
+
+	Link.iElementSize = sizeof(E);
+	Link.iIndexes = std::is_array_v<M> ? std::extent_v<M> : 1;
+	Link.iOffset = iOffset;
+	Link.pSection = szSection;
+	Link.pKey = szKey;
+	Link.iHash = StructHash::Key(szSection, szKey);
+
+	return Link;
+}
+
+#define STRUCT_FIELD(Struct, Member, Section, Key) MakeStructLink<decltype(Struct::Member)>(offsetof(Struct, Member), Section, Key)
+
+// Links and lookup table for a struct, built at compile time. See MakeStructSchema().
+template<typename T, size_t N>
+struct StructSchema
+{
+	static constexpr size_t
+				TABLE_SIZE = StructTable::Size(N);
+
+	StructLink	Links[N] = {};
+	int			Table[TABLE_SIZE] = {};
+
+	constexpr StructSchema(const StructLink (&SourceLinks)[N])
+	{
+		for (size_t i = 0; i < N; ++i)
+			Links[i] = SourceLinks[i];
+
+		StructTable::Build(Links, N, Table, TABLE_SIZE);
+	}
+
+	// Changes whenever a link is added, removed or changed, or the size of T changes. Used to invalidate cached images of T.
+	constexpr unsigned int GetHash() const
+	{
+		unsigned int
+			iHash = StructHash::Mix(StructHash::BASIS, sizeof(T));
+
+		for (size_t i = 0; i < N; ++i)
+		{
+			iHash = StructHash::Mix(iHash, Links[i].iHash);
+			iHash = StructHash::Mix(iHash, (size_t)Links[i].iType);
+			iHash = StructHash::Mix(iHash, Links[i].iElementSize);
+			iHash = StructHash::Mix(iHash, Links[i].iIndexes);
+			iHash = StructHash::Mix(iHash, Links[i].iOffset);
+		}
+
+		return iHash;
+	}
+};
+
+template<typename T, size_t N>
+constexpr StructSchema<T, N> MakeStructSchema(const StructLink (&Links)[N])
+{
+	static_assert(std::is_standard_layout_v<T>, "offsetof requires a standard layout struct");
+
+	return StructSchema<T, N>(Links);
+}
+
+// ------------------------------------------------------
+
+// Decoded values of one or more sources, see StructParser::Parse(..., StructDocument&).
+// Holds the bytes of every linked value that was found, so applying it to a struct is just a copy per value.
+// Parsing more sources into the same document (or merging documents) overrides values per link, the last one wins.
+
+template<typename T>
+class StructDocument
+{
+private:
+
+	struct SEntry
+	{
+		size_t	iLink; // Index of the link in the parser that created the entry
+		size_t	iOffset; // Offset in the target struct
+		size_t	iData; // Offset in m_vData
+		size_t	iSize;
+	};
+
+	std::vector<SEntry>
+				m_vEntries;
+
+	std::vector<int>
+				m_vEntryByLink; // -1 if the link has no value
+
+	std::vector<unsigned char>
+				m_vData;
+
+public:
+
+	// Adds or replaces the value of a link. A value that grows is appended, the old bytes stay unused until Clear().
+	void Set(size_t iLink, size_t iOffset, const void* pData, size_t iSize)
+	{
+		if (iOffset + iSize > sizeof(T))
+			return;
+
+		if (iLink >= m_vEntryByLink.size())
+			m_vEntryByLink.resize(iLink + 1, -1);
+
+		if (m_vEntryByLink[iLink] == -1)
+		{
+			m_vEntryByLink[iLink] = (int)m_vEntries.size();
+			m_vEntries.push_back({ iLink, iOffset, m_vData.size(), 0 });
+		}
+
+		SEntry
+			&Entry = m_vEntries[m_vEntryByLink[iLink]];
+
+		if (iSize > Entry.iSize)
+		{
+			Entry.iData = m_vData.size();
+			m_vData.resize(m_vData.size() + iSize);
+		}
+
+		Entry.iOffset = iOffset;
+		Entry.iSize = iSize;
+
+		memcpy(m_vData.data() + Entry.iData, pData, iSize);
+	}
+
+	// Values of Document override the ones in this document. Both must have been created with the same links.
+	void Merge(const StructDocument& Document)
+	{
+		for (auto &Entry : Document.m_vEntries)
+			Set(Entry.iLink, Entry.iOffset, Document.m_vData.data() + Entry.iData, Entry.iSize);
+	}
+
+	// Copies every value into pTarget, members without a value are left untouched.
+	void Apply(T* pTarget) const
+	{
+		for (auto &Entry : m_vEntries)
+			memcpy((char*)pTarget + Entry.iOffset, m_vData.data() + Entry.iData, Entry.iSize);
+	}
+
+	void Clear()
+	{
+		m_vEntries.clear();
+		m_vEntryByLink.clear();
+		m_vData.clear();
+	}
+
+	bool HasValue(size_t iLink) const
+	{
+		return iLink < m_vEntryByLink.size() && m_vEntryByLink[iLink] != -1;
+	}
+
+	size_t GetCount() const
+	{
+		return m_vEntries.size();
+	}
+};
+
+// ------------------------------------------------------
+
+template<typename T>
+class StructStream;
+
+template<typename T>
+class StructParser
+{
+	friend class StructStream<T>;
+
+public:
+
+	static constexpr size_t
+				PARALLEL_MIN_PART = 64 * 1024; // Minimum size of a part for ParseParallel()
+
+private:
+
+	T*			m_pBase;
+
+	// Links and table in use, either from a static schema or from m_vLinks/m_vTable
+
+	const StructLink
+				*m_pLinks = nullptr;
+
+	size_t		m_iLinkCount = 0;
+
+	const int	*m_pTable = nullptr;
+
+	size_t		m_iTableSize = 0;
+
+	// Runtime links created by Link(), they own their section and key strings
+
+	std::vector<StructLink>
+				m_vLinks;
+
+	std::vector<int>
+				m_vTable;
+
+	bool		m_bTableDirty = false;
+	bool		m_bStaticSchema = false;
+
+	size_t		m_iErrorCount = 0;
+	int			m_iLastError = ParseError::NONE;
+
+	std::vector<unsigned char>
+				m_vScratch; // Values are decoded into this before being added to a document
+
+	void _BuildTable()
+	{
+		m_vTable.resize(StructTable::Size(m_vLinks.size()));
+
+		StructTable::Build(m_vLinks.data(), m_vLinks.size(), m_vTable.data(), m_vTable.size());
+
+		m_pLinks = m_vLinks.data();
+		m_iLinkCount = m_vLinks.size();
+		m_pTable = m_vTable.data();
+		m_iTableSize = m_vTable.size();
+
+		m_bTableDirty = false;
+	}
+
+	static bool _CmpStr(std::string_view Text1, std::string_view Text2, bool bIgnoreCase)
+	{
+		if (Text1.size() != Text2.size())
+			return false;
+
+		if (bIgnoreCase)
+			return StructValue::EqualsNoCase(Text1, Text2);
+
+		return Text1 == Text2;
+	}
+
+	// Removes spaces from both ends, without touching the source.
+	static std::string_view _RemovePadding(std::string_view Text)
+	{
+		size_t
+			iFirstChar = Text.find_first_not_of(' ');
+
+		if (iFirstChar == std::string_view::npos)
+			return std::string_view(Text.data(), 0);
+
+		return Text.substr(iFirstChar, Text.find_last_not_of(' ') - iFirstChar + 1);
+	}
+
+	// Splits a line into key and value, the value ends at the next '=', if any. Returns false if it's not a key/value pair.
+	static bool _SplitLine(std::string_view Line, std::string_view& Key, std::string_view& Value)
+	{
+		size_t
+			iSeparator = Line.find('=');
+
+		if (iSeparator == std::string_view::npos)
+			return false;
+
+		Key = _RemovePadding(Line.substr(0, iSeparator));
+
+		if (Key.empty())
+			return false;
+
+		Value = Line.substr(iSeparator + 1);
+		Value = Value.substr(std::min(Value.find_first_not_of('='), Value.size()));
+		Value = _RemovePadding(Value.substr(0, Value.find('=')));
+
+		return !Value.empty();
+	}
+
+	// Calls fnLink(iLink) for every link of the key, there can be multiple links for the same key.
+	template<typename F>
+	void _ForEachLink(std::string_view Section, std::string_view Key, bool bIgnoreCase, F fnLink)
+	{
+		size_t
+			iSlot,
+			iMask;
+
+		unsigned int
+			iHash;
+
+		if (m_bTableDirty)
+			_BuildTable();
+
+		if (!m_iTableSize)
+			return;
+
+		iHash = StructHash::Key(Section.data(), Section.size(), Key.data(), Key.size());
+		iMask = m_iTableSize - 1;
+
+		// Walk the probe sequence until an empty slot
+
+		for (iSlot = iHash & iMask; m_pTable[iSlot] != -1; iSlot = (iSlot + 1) & iMask)
+		{
+			const StructLink
+				*pLink = &m_pLinks[m_pTable[iSlot]];
+
+			// Check if the current value and link have either no section, or the same section
+			// and if the keys match.
+
+			if (pLink->iHash == iHash &&
+				((!Section.data() && !pLink->pSection) || (Section.data() && pLink->pSection && _CmpStr(Section, pLink->pSection, bIgnoreCase))) &&
+				_CmpStr(Key, pLink->pKey, bIgnoreCase)
+				)
+				fnLink((size_t)m_pTable[iSlot]);
+		}
+	}
+
+	// Counts a failed value, returns false if there was an error.
+	bool _CheckResult(int iResult)
+	{
+		if (iResult == ParseError::NONE)
+			return true;
+
+		++m_iErrorCount;
+		m_iLastError = iResult;
+		return false;
+	}
+
+	// Calls fnLine(Section, Line) for every line that is not a section header. Returns -1 if the source is empty.
+	template<typename F>
+	int _ParseLines(const char* pSource, size_t iSourceLen, F fnLine)
+	{
+		std::string_view
+			Line,
+			Section; // data() == nullptr if there is no section
+
+		int
+			iParsedValues = 0;
+
+		size_t
+			iLen = (iSourceLen == 0 ? strlen(pSource) : iSourceLen),
+			iLineStart = 0;
+
+		if (!iLen)
+			return -1;
+
+		m_iErrorCount = 0;
+		m_iLastError = ParseError::NONE;
+
+		for (size_t i = 0; i <= iLen; ++i)
+		{
+			if (i < iLen && pSource[i] != '\r' && pSource[i] != '\n' && pSource[i] != 0)
+				continue;
+
+			Line = std::string_view(pSource + iLineStart, i - iLineStart);
+			iLineStart = i + 1;
+
+			// Remove padding and check remaining length
+
+			if (Line.size() < 2)
+				continue;
+
+			Line = _RemovePadding(Line);
+
+			if (Line.size() < 2)
+				continue;
+
+			if (Line.front() == '[' && Line.back() == ']')
+			{
+				// After removing [ and ] make sure there is text left, otherwise reset the section
+
+				Section = _RemovePadding(Line.substr(1, Line.size() - 2));
+
+				if (Section.empty())
+					Section = std::string_view();
+			}
+			else
+			{
+				// If this is a value, parse it
+
+				if (fnLine(Section, Line))
+					++iParsedValues;
+			}
+		}
+
+		return iParsedValues;
+	}
+
+	// Uses the links of Parser without owning them, for parsing on other threads. Link() can't be used afterwards.
+	void _ShareLinks(StructParser& Parser)
+	{
+		if (Parser.m_bTableDirty)
+			Parser._BuildTable();
+
+		m_pLinks = Parser.m_pLinks;
+		m_iLinkCount = Parser.m_iLinkCount;
+		m_pTable = Parser.m_pTable;
+		m_iTableSize = Parser.m_iTableSize;
+		m_bStaticSchema = true;
+	}
+
+	// Returns true if the line starting at pLine is a section header.
+	static bool _IsSectionLine(const char* pLine, const char* pEnd)
+	{
+		const char
+			*pLineEnd = pLine;
+
+		std::string_view
+			Line;
+
+		while (pLineEnd < pEnd && *pLineEnd != '\r' && *pLineEnd != '\n' && *pLineEnd != 0)
+			++pLineEnd;
+
+		Line = _RemovePadding(std::string_view(pLine, pLineEnd - pLine));
+
+		return Line.size() >= 2 && Line.front() == '[' && Line.back() == ']';
+	}
+
+	// Start of the first section header at or after pFrom, or pEnd if there is none.
+	static const char* _FindSection(const char* pFrom, const char* pStart, const char* pEnd)
+	{
+		for (const char* p = pFrom; p < pEnd; ++p)
+		{
+			if (*p != '[' || (p != pStart && p[-1] != '\r' && p[-1] != '\n' && p[-1] != 0))
+				continue;
+
+			if (_IsSectionLine(p, pEnd))
+				return p;
+		}
+
+		return pEnd;
+	}
+
+	static void _AppendKey(const StructLink& Link, const T* pSource, const std::string& NewLine, std::string& Output)
+	{
+		Output.append(Link.pKey).append(" = ");
+		StructValue::Encode(Link.iType, Link.iElementSize, Link.iIndexes, (const char*)pSource + Link.iOffset, Output);
+		Output.append(NewLine);
+	}
+
+public:
+
+	StructParser(T* pBase = nullptr) :
+		m_pBase(pBase)
+	{
+
+	}
+
+	// The schema is not copied and must outlive the parser (ie. static constexpr). Link() can't be used.
+	template<size_t N>
+	StructParser(const StructSchema<T, N>& Schema) :
+		m_pBase(nullptr),
+		m_pLinks(Schema.Links),
+		m_iLinkCount(N),
+		m_pTable(Schema.Table),
+		m_iTableSize(StructSchema<T, N>::TABLE_SIZE),
+		m_bStaticSchema(true)
+	{
+
+	}
+
+	~StructParser()
+	{
+		ResetLinks();
+	}
+
+	void SetBase(T* pBase = nullptr)
+	{
+		m_pBase = pBase;
+	}
+
+	// iType: See LinkType::
+	// iElementSize: Size of one element in bytes ie. sizeof(type). Supported sizes: 1, 2, 4, 8
+	// iIndexes: The amount of indexes. If the array size is unknown you can use 0, however this is only safe for properly
+	//   terminated char strings that are guaranteed to fit.
+	// pTarget: Target variable within the base struct.
+	// szSection: Name of the INI section.
+	// szKey: Name of the INI key.
+	bool Link(int iType, void* pTarget, size_t iElementSize, size_t iIndexes, const char* szSection, const char* szKey)
+	{
+		StructLink
+			Link;
+
+		char
+			*pText;
+
+		size_t
+			iLen,
+			iOffset;
+
+		if (m_bStaticSchema || iType < 0 || iType >= LinkType::MAX || !m_pBase || (size_t)(void*)pTarget < (size_t)(void*)m_pBase)
+			return false;
+
+		iOffset = (size_t)(void*)pTarget - (size_t)(void*)m_pBase;
+
+		if (iOffset + iElementSize * (iIndexes == 0 ? 1 : iIndexes) > sizeof(T))
+			return false;
+
+		Link.iType = iType;
+		Link.iElementSize = iElementSize;
+		Link.iIndexes = iIndexes;
+
+		Link.iOffset = iOffset;
+
+		iLen = strlen(szSection) + 1;
+		pText = new char[iLen];
+		memcpy(pText, szSection, iLen);
+		Link.pSection = pText;
+
+		iLen = strlen(szKey) + 1;
+		pText = new char[iLen];
+		memcpy(pText, szKey, iLen);
+		Link.pKey = pText;
+
+		Link.iHash = StructHash::Key(szSection, szKey);
+
+		m_vLinks.push_back(Link);
+		m_bTableDirty = true;
+
+		return true;
+	}
+
+	void ResetLinks()
+	{
+		for (auto &Link : m_vLinks)
+		{
+			delete[] Link.pSection;
+			delete[] Link.pKey;
+		}
+
+		m_vLinks.clear();
+		m_vTable.clear();
+		m_bTableDirty = false;
+		m_bStaticSchema = false;
+
+		m_pLinks = nullptr;
+		m_iLinkCount = 0;
+		m_pTable = nullptr;
+		m_iTableSize = 0;
+	}
+
+	// The file is memory mapped and parsed in place, files that can't be mapped are streamed through a small buffer.
+	int ParseFile(const char* szFileName, T* pTarget, bool bIgnoreCase = true)
+	{
+		MappedFile
+			File;
+
+		if (File.Open(szFileName, false) && File.GetSize())
+			return Parse(File.GetData(), pTarget, bIgnoreCase, File.GetSize());
+
+		StructStream<T>
+			Stream(*this, pTarget, bIgnoreCase);
+
+		return Stream.FeedFile(szFileName);
+	}
+
+	// Same as above, the values are added to Document (see StructDocument).
+	int ParseFile(const char* szFileName, StructDocument<T>& Document, bool bIgnoreCase = true)
+	{
+		MappedFile
+			File;
+
+		if (File.Open(szFileName, false) && File.GetSize())
+			return Parse(File.GetData(), Document, bIgnoreCase, File.GetSize());
+
+		StructStream<T>
+			Stream(*this, Document, bIgnoreCase);
+
+		return Stream.FeedFile(szFileName);
+	}
+
+	int Parse(const char* pSource, T* pTarget, bool bIgnoreCase = true, size_t iSourceLen = 0)
+	{
+		return _ParseLines(pSource, iSourceLen, [&](std::string_view Section, std::string_view Line)
+		{
+			return ParseValue(Section, Line, pTarget, bIgnoreCase);
+		});
+	}
+
+	// Decodes the source once into Document, which can then be applied to any number of targets.
+	// Values already in the document are overridden, so layered sources can be parsed into the same document.
+	int Parse(const char* pSource, StructDocument<T>& Document, bool bIgnoreCase = true, size_t iSourceLen = 0)
+	{
+		return _ParseLines(pSource, iSourceLen, [&](std::string_view Section, std::string_view Line)
+		{
+			return ParseValue(Section, Line, Document, bIgnoreCase);
+		});
+	}
+
+	// Same as Parse() into a document, but the source is split at section headers and the parts are parsed on up to
+	// iThreadCount threads (0 = one per hardware thread). Every part starts with its own section, so the parts are
+	// independent. They are merged in source order, so the last value of a key still wins.
+	// Every part is at least PARALLEL_MIN_PART long and only one thread per part is started, so small sources or sources
+	// with few sections use fewer threads, down to a plain Parse() on the calling thread.
+	int ParseParallel(const char* pSource, StructDocument<T>& Document, size_t iThreadCount = 0, bool bIgnoreCase = true, size_t iSourceLen = 0)
+	{
+		size_t
+			iLen = (iSourceLen == 0 ? strlen(pSource) : iSourceLen),
+			iPartCount;
+
+		std::vector<const char*>
+			vPartStart;
+
+		std::vector<StructDocument<T>>
+			vDocuments;
+
+		std::vector<StructParser>
+			vWorkers;
+
+		std::vector<int>
+			vResults;
+
+		std::vector<std::thread>
+			vThreads;
+
+		int
+			iParsedValues = 0;
+
+		if (!iLen)
+			return -1;
+
+		if (iThreadCount == 0)
+			iThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		iThreadCount = std::min(iThreadCount, std::max<size_t>(1, iLen / PARALLEL_MIN_PART));
+
+		if (iThreadCount <= 1)
+			return Parse(pSource, Document, bIgnoreCase, iLen);
+
+		// Split into parts of roughly the same size, each one starting at a section header. A large section can push the
+		// next header past later split points, those are skipped instead of starting a thread for a few bytes.
+
+		vPartStart.push_back(pSource);
+
+		for (size_t i = 1; i < iThreadCount; ++i)
+		{
+			const char
+				*pStart = _FindSection(std::max(pSource + iLen * i / iThreadCount, vPartStart.back() + PARALLEL_MIN_PART), pSource, pSource + iLen);
+
+			if (pSource + iLen - pStart < (ptrdiff_t)PARALLEL_MIN_PART)
+				break;
+
+			vPartStart.push_back(pStart);
+		}
+
+		if (vPartStart.size() == 1)
+			return Parse(pSource, Document, bIgnoreCase, iLen);
+
+		vPartStart.push_back(pSource + iLen);
+		iPartCount = vPartStart.size() - 1;
+
+		vDocuments.resize(iPartCount);
+		vWorkers.resize(iPartCount);
+		vResults.resize(iPartCount);
+
+		for (size_t i = 0; i < iPartCount; ++i)
+			vWorkers[i]._ShareLinks(*this);
+
+		auto fnParsePart = [&](size_t i)
+		{
+			vResults[i] = vWorkers[i].Parse(vPartStart[i], vDocuments[i], bIgnoreCase, vPartStart[i + 1] - vPartStart[i]);
+		};
+
+		// The calling thread parses the first part itself
+
+		for (size_t i = 1; i < iPartCount; ++i)
+			vThreads.emplace_back(fnParsePart, i);
+
+		fnParsePart(0);
+
+		for (auto &Thread : vThreads)
+			Thread.join();
+
+		// Merge in source order
+
+		m_iErrorCount = 0;
+		m_iLastError = ParseError::NONE;
+
+		for (size_t i = 0; i < iPartCount; ++i)
+		{
+			Document.Merge(vDocuments[i]);
+
+			iParsedValues += std::max(vResults[i], 0);
+			m_iErrorCount += vWorkers[i].m_iErrorCount;
+
+			if (vWorkers[i].m_iLastError != ParseError::NONE)
+				m_iLastError = vWorkers[i].m_iLastError;
+		}
+
+		return iParsedValues;
+	}
+
+	int ParseParallel(const char* pSource, T* pTarget, size_t iThreadCount = 0, bool bIgnoreCase = true, size_t iSourceLen = 0)
+	{
+		StructDocument<T>
+			Document;
+
+		int
+			iParsedValues = ParseParallel(pSource, Document, iThreadCount, bIgnoreCase, iSourceLen);
+
+		Document.Apply(pTarget);
+
+		return iParsedValues;
+	}
+
+	// Writes the linked values of pSource into an INI file, creating it if it doesn't exist.
+	// Values in the file that already decode to the same value are left alone, only the text of the others is replaced.
+	// Keys that are missing are added at the end of their section (the section is added if needed), keys without a
+	// section before the first section. Comments, order and formatting of everything else are kept.
+	// The file is only written if something changed, through a temporary file (see WriteFileAtomic()).
+	// Returns the amount of values that were changed or added, or -1 if the file couldn't be written.
+	int Update(const char* szFileName, const T* pSource, bool bIgnoreCase = true)
+	{
+		struct SEdit
+		{
+			size_t		iOffset;
+			size_t		iLength; // Characters replaced, 0 to insert
+			size_t		iLink;
+		};
+
+		struct SSectionEnd
+		{
+			std::string_view
+						Section;
+			size_t		iOffset; // End of the last line in the section
+		};
+
+		MappedFile
+			File;
+
+		std::vector<SEdit>
+			vEdits;
+
+		std::vector<SSectionEnd>
+			vSectionEnds;
+
+		std::vector<bool>
+			vFound;
+
+		std::vector<size_t>
+			vNewLinks;
+
+		std::string_view
+			Source,
+			Section,
+			Line,
+			Key,
+			Value;
+
+		std::string
+			Output,
+			NewLine = "\r\n";
+
+		size_t
+			iLineStart = 0,
+			iLineEnd,
+			iFirstSection = std::string_view::npos,
+			iCopied = 0,
+			iValueSize;
+
+		int
+			iChanged = 0;
+
+		if (m_bTableDirty)
+			_BuildTable();
+
+		if (File.Open(szFileName))
+			Source = std::string_view(File.GetData(), File.GetSize());
+
+		if (Source.find('\n') != std::string_view::npos && Source.find("\r\n") == std::string_view::npos)
+			NewLine = "\n";
+
+		vFound.resize(m_iLinkCount, false);
+
+		if (m_vScratch.size() < sizeof(T))
+			m_vScratch.resize(sizeof(T));
+
+		// Find the values that differ and where each section ends
+
+		while (iLineStart < Source.size())
+		{
+			iLineEnd = iLineStart;
+
+			while (iLineEnd < Source.size() && Source[iLineEnd] != '\r' && Source[iLineEnd] != '\n' && Source[iLineEnd] != 0)
+				++iLineEnd;
+
+			Line = _RemovePadding(Source.substr(iLineStart, iLineEnd - iLineStart));
+
+			if (iLineEnd < Source.size() && Source[iLineEnd] == '\r' && iLineEnd + 1 < Source.size() && Source[iLineEnd + 1] == '\n')
+				++iLineEnd;
+
+			if (iLineEnd < Source.size())
+				++iLineEnd;
+
+			if (Line.size() >= 2 && Line.front() == '[' && Line.back() == ']')
+			{
+				Section = _RemovePadding(Line.substr(1, Line.size() - 2));
+
+				if (Section.empty())
+					Section = std::string_view();
+
+				if (iFirstSection == std::string_view::npos)
+					iFirstSection = iLineStart;
+			}
+			else if (Line.size() >= 2 && _SplitLine(Line, Key, Value))
+			{
+				_ForEachLink(Section, Key, bIgnoreCase, [&](size_t iLink)
+				{
+					const StructLink
+						&Link = m_pLinks[iLink];
+
+					const char
+						*pValue = (const char*)pSource + Link.iOffset;
+
+					size_t
+						iWritten = 0;
+
+					vFound[iLink] = true;
+
+					iValueSize = StructValue::EncodedSize(Link.iType, Link.iElementSize, Link.iIndexes, pValue);
+
+					if (iValueSize > m_vScratch.size())
+						m_vScratch.resize(iValueSize);
+
+					if (StructValue::Decode(Link.iType, Link.iElementSize, Link.iIndexes, Value, m_vScratch.data(), &iWritten) == ParseError::NONE &&
+						iWritten == iValueSize && memcmp(m_vScratch.data(), pValue, iValueSize) == 0)
+						return;
+
+					vEdits.push_back({ (size_t)(Value.data() - Source.data()), Value.size(), iLink });
+				});
+			}
+
+			// Remember the end of the last line in this section that isn't empty, new keys go there
+
+			if (!Line.empty())
+			{
+				auto it = std::find_if(vSectionEnds.begin(), vSectionEnds.end(), [&](const SSectionEnd& SectionEnd)
+				{
+					return (!SectionEnd.Section.data() && !Section.data()) ||
+						(SectionEnd.Section.data() && Section.data() && _CmpStr(SectionEnd.Section, Section, bIgnoreCase));
+				});
+
+				if (it == vSectionEnds.end())
+					vSectionEnds.push_back({ Section, iLineEnd });
+				else
+					it->iOffset = iLineEnd;
+			}
+
+			iLineStart = iLineEnd;
+		}
+
+		// Keys without a section must come before the first section
+
+		if (iFirstSection == std::string_view::npos)
+			iFirstSection = Source.size();
+
+		for (auto &SectionEnd : vSectionEnds)
+			if (!SectionEnd.Section.data())
+				SectionEnd.iOffset = std::min(SectionEnd.iOffset, iFirstSection);
+
+		// Add missing keys at the end of their section, iLength = npos marks an insert.
+		// Keys of sections that don't exist yet are collected and added at the end of the file.
+
+		for (size_t i = 0; i < m_iLinkCount; ++i)
+		{
+			const StructLink
+				&Link = m_pLinks[i];
+
+			auto it = std::find_if(vSectionEnds.begin(), vSectionEnds.end(), [&](const SSectionEnd& SectionEnd)
+			{
+				return (!SectionEnd.Section.data() && !Link.pSection) ||
+					(SectionEnd.Section.data() && Link.pSection && _CmpStr(SectionEnd.Section, Link.pSection, bIgnoreCase));
+			});
+
+			if (vFound[i])
+				continue;
+
+			if (it != vSectionEnds.end())
+				vEdits.push_back({ it->iOffset, std::string_view::npos, i });
+			else if (!Link.pSection)
+				vEdits.push_back({ iFirstSection, std::string_view::npos, i });
+			else
+				vNewLinks.push_back(i);
+		}
+
+		if (vEdits.empty() && vNewLinks.empty())
+			return 0;
+
+		std::stable_sort(vEdits.begin(), vEdits.end(), [](const SEdit& Edit1, const SEdit& Edit2)
+		{
+			return Edit1.iOffset < Edit2.iOffset;
+		});
+
+		// Copy the unchanged parts as they are and write the new values in between
+
+		Output.reserve(Source.size() + vEdits.size() * 32);
+
+		for (size_t i = 0; i < vEdits.size(); ++i)
+		{
+			const SEdit
+				&Edit = vEdits[i];
+
+			const StructLink
+				&Link = m_pLinks[Edit.iLink];
+
+			Output.append(Source.data() + iCopied, Edit.iOffset - iCopied);
+			iCopied = Edit.iOffset;
+
+			if (Edit.iLength != std::string_view::npos)
+			{
+				StructValue::Encode(Link.iType, Link.iElementSize, Link.iIndexes, (const char*)pSource + Link.iOffset, Output);
+				iCopied += Edit.iLength;
+			}
+			else
+			{
+				if (!Output.empty() && Output.back() != '\n' && Output.back() != '\r')
+					Output.append(NewLine);
+
+				_AppendKey(Link, pSource, NewLine, Output);
+			}
+
+			++iChanged;
+		}
+
+		Output.append(Source.data() + iCopied, Source.size() - iCopied);
+
+		// New sections, each one with all of its keys
+
+		for (size_t i = 0; i < vNewLinks.size(); ++i)
+		{
+			const StructLink
+				&Link = m_pLinks[vNewLinks[i]];
+
+			bool
+				bWritten = false;
+
+			for (size_t j = 0; j < i && !bWritten; ++j)
+				bWritten = _CmpStr(m_pLinks[vNewLinks[j]].pSection, Link.pSection, bIgnoreCase);
+
+			if (bWritten)
+				continue;
+
+			if (!Output.empty() && Output.back() != '\n' && Output.back() != '\r')
+				Output.append(NewLine);
+
+			if (!Output.empty())
+				Output.append(NewLine);
+
+			Output.append("[").append(Link.pSection).append("]").append(NewLine);
+
+			for (size_t j = i; j < vNewLinks.size(); ++j)
+			{
+				if (!_CmpStr(m_pLinks[vNewLinks[j]].pSection, Link.pSection, bIgnoreCase))
+					continue;
+
+				_AppendKey(m_pLinks[vNewLinks[j]], pSource, NewLine, Output);
+				++iChanged;
+			}
+		}
+
+		File.Close();
+
+		if (!WriteFileAtomic(szFileName, Output.data(), Output.size()))
+			return -1;
+
+		return iChanged;
+	}
+
+	// Section: Name of the current section, pass a view with data() == nullptr if there is none.
+	// Line: The full line, ie. "key = value".
+	// Returns false if the line is not a key/value pair or if the value couldn't be converted.
+	bool ParseValue(std::string_view Section, std::string_view Line, T* pTarget, bool bIgnoreCase)
+	{
+		std::string_view
+			Key,
+			Value;
+
+		int
+			iResult = ParseError::NONE;
+
+		if (!_SplitLine(Line, Key, Value))
+			return false;
+
+		_ForEachLink(Section, Key, bIgnoreCase, [&](size_t iLink)
+		{
+			const StructLink
+				&Link = m_pLinks[iLink];
+
+			size_t
+				iWritten = 0;
+
+			int
+				iError;
+
+			// Lists can fail halfway through, they are decoded into the scratch buffer first so the target is only written on success
+
+			if (Link.iType != LinkType::STRING && Link.iIndexes > 1)
+			{
+				if (m_vScratch.size() < Link.iElementSize * Link.iIndexes)
+					m_vScratch.resize(Link.iElementSize * Link.iIndexes);
+
+				iError = StructValue::Decode(Link.iType, Link.iElementSize, Link.iIndexes, Value, m_vScratch.data(), &iWritten);
+
+				// Elements after the last value are cleared, so a shorter list from a later source replaces a longer one
+
+				if (iError == ParseError::NONE)
+				{
+					memset(m_vScratch.data() + iWritten, 0, Link.iElementSize * Link.iIndexes - iWritten);
+					memcpy((char*)pTarget + Link.iOffset, m_vScratch.data(), Link.iElementSize * Link.iIndexes);
+				}
+			}
+			else
+			{
+				iError = StructValue::Decode(Link.iType, Link.iElementSize, Link.iIndexes, Value, (char*)pTarget + Link.iOffset);
+			}
+
+			if (iError != ParseError::NONE)
+				iResult = iError;
+		});
+
+		return _CheckResult(iResult);
+	}
+
+	bool ParseValue(std::string_view Section, std::string_view Line, StructDocument<T>& Document, bool bIgnoreCase)
+	{
+		std::string_view
+			Key,
+			Value;
+
+		int
+			iResult = ParseError::NONE;
+
+		if (!_SplitLine(Line, Key, Value))
+			return false;
+
+		_ForEachLink(Section, Key, bIgnoreCase, [&](size_t iLink)
+		{
+			const StructLink
+				&Link = m_pLinks[iLink];
+
+			size_t
+				iWritten = 0,
+				iSize = Link.iElementSize * (Link.iIndexes == 0 ? Value.size() + 1 : Link.iIndexes);
+
+			int
+				iError;
+
+			if (m_vScratch.size() < iSize)
+				m_vScratch.resize(iSize);
+
+			iError = StructValue::Decode(Link.iType, Link.iElementSize, Link.iIndexes, Value, m_vScratch.data(), &iWritten);
+
+			if (iError != ParseError::NONE)
+			{
+				iResult = iError;
+				return;
+			}
+
+			// Same as parsing into a struct, lists are stored with their unused elements cleared
+
+			if (Link.iType != LinkType::STRING && Link.iIndexes > 1)
+			{
+				memset(m_vScratch.data() + iWritten, 0, iSize - iWritten);
+				iWritten = iSize;
+			}
+
+			Document.Set(iLink, Link.iOffset, m_vScratch.data(), iWritten);
+		});
+
+		return _CheckResult(iResult);
+	}
+
+	// Same as above for terminated strings, pSection can be nullptr.
+	bool ParseValue(const char* pSection, const char* pLine, T* pTarget, bool bIgnoreCase)
+	{
+		return ParseValue(pSection ? std::string_view(pSection) : std::string_view(), std::string_view(pLine), pTarget, bIgnoreCase);
+	}
+
+	// Amount of values that couldn't be converted during the last Parse/ParseFile call.
+	size_t GetErrorCount() const
+	{
+		return m_iErrorCount;
+	}
+
+	// See ParseError::
+	int GetLastError() const
+	{
+		return m_iLastError;
+	}
+};
+
+// ------------------------------------------------------
+
+// Push parser for data that arrives in chunks of any size. Lines can be split anywhere between chunks.
+// Memory use is bounded by LINE_SIZE, longer lines are skipped and counted as ParseError::LENGTH.
+// Uses the links and error counters of the parser it was created with.
+
+template<typename T>
+class StructStream
+{
+public:
+
+	static constexpr size_t
+				LINE_SIZE = 1024,
+				READ_SIZE = 4096;
+
+private:
+
+	StructParser<T>
+				&m_Parser;
+
+	T*			m_pTarget = nullptr;
+
+	StructDocument<T>
+				*m_pDocument = nullptr;
+
+	bool		m_bIgnoreCase;
+
+	char		m_szLine[LINE_SIZE]; // Partial line from the previous chunk
+	size_t		m_iLineLen = 0;
+	bool		m_bLineTooLong = false;
+
+	char		m_szSection[LINE_SIZE];
+	size_t		m_iSectionLen = 0;
+	bool		m_bSection = false;
+
+	bool		m_bStarted = false;
+	int			m_iParsedValues = 0;
+
+	void _Start()
+	{
+		if (m_bStarted)
+			return;
+
+		m_bStarted = true;
+		m_iParsedValues = 0;
+
+		m_Parser.m_iErrorCount = 0;
+		m_Parser.m_iLastError = ParseError::NONE;
+	}
+
+	void _Append(const char* pData, size_t iLen)
+	{
+		if (m_bLineTooLong || m_iLineLen + iLen > LINE_SIZE)
+		{
+			m_bLineTooLong = true;
+			return;
+		}
+
+		memcpy(m_szLine + m_iLineLen, pData, iLen);
+		m_iLineLen += iLen;
+	}
+
+	// Same rules as StructParser::Parse() for a single line.
+	void _ParseLine(std::string_view Line)
+	{
+		std::string_view
+			Section;
+
+		if (Line.size() < 2)
+			return;
+
+		Line = StructParser<T>::_RemovePadding(Line);
+
+		if (Line.size() < 2)
+			return;
+
+		if (Line.front() == '[' && Line.back() == ']')
+		{
+			// The section has to be copied, the line may be gone with the next chunk
+
+			Section = StructParser<T>::_RemovePadding(Line.substr(1, Line.size() - 2));
+
+			memcpy(m_szSection, Section.data(), Section.size());
+			m_iSectionLen = Section.size();
+			m_bSection = !Section.empty();
+		}
+		else
+		{
+			Section = m_bSection ? std::string_view(m_szSection, m_iSectionLen) : std::string_view();
+
+			if (m_pDocument ? m_Parser.ParseValue(Section, Line, *m_pDocument, m_bIgnoreCase) : m_Parser.ParseValue(Section, Line, m_pTarget, m_bIgnoreCase))
+				++m_iParsedValues;
+		}
+	}
+
+	// Parses the buffered line, if any.
+	void _FlushLine()
+	{
+		if (m_bLineTooLong)
+			m_Parser._CheckResult(ParseError::LENGTH);
+		else if (m_iLineLen)
+			_ParseLine(std::string_view(m_szLine, m_iLineLen));
+
+		m_iLineLen = 0;
+		m_bLineTooLong = false;
+	}
+
+public:
+
+	StructStream(StructParser<T>& Parser, T* pTarget, bool bIgnoreCase = true) :
+		m_Parser(Parser),
+		m_pTarget(pTarget),
+		m_bIgnoreCase(bIgnoreCase)
+	{
+
+	}
+
+	StructStream(StructParser<T>& Parser, StructDocument<T>& Document, bool bIgnoreCase = true) :
+		m_Parser(Parser),
+		m_pDocument(&Document),
+		m_bIgnoreCase(bIgnoreCase)
+	{
+
+	}
+
+	// Complete lines are parsed straight from pData, only the unterminated rest is copied.
+	void Feed(const char* pData, size_t iLen)
+	{
+		size_t
+			iLineStart = 0;
+
+		if (!iLen)
+			return;
+
+		_Start();
+
+		for (size_t i = 0; i < iLen; ++i)
+		{
+			if (pData[i] != '\r' && pData[i] != '\n' && pData[i] != 0)
+				continue;
+
+			if (m_iLineLen || m_bLineTooLong)
+			{
+				_Append(pData + iLineStart, i - iLineStart);
+				_FlushLine();
+			}
+			else if (i - iLineStart > LINE_SIZE)
+			{
+				m_Parser._CheckResult(ParseError::LENGTH);
+			}
+			else
+			{
+				_ParseLine(std::string_view(pData + iLineStart, i - iLineStart));
+			}
+
+			iLineStart = i + 1;
+		}
+
+		_Append(pData + iLineStart, iLen - iLineStart);
+	}
+
+	// Parses the last line and returns the amount of parsed values like StructParser::Parse(), -1 if nothing was fed.
+	// The stream can be used again afterwards.
+	int Finish()
+	{
+		int
+			iParsedValues;
+
+		_FlushLine();
+
+		iParsedValues = m_bStarted ? m_iParsedValues : -1;
+
+		m_bStarted = false;
+		m_bSection = false;
+		m_iSectionLen = 0;
+		m_iParsedValues = 0;
+
+		return iParsedValues;
+	}
+
+	// Feeds the whole file in READ_SIZE chunks and finishes. Works for anything fopen can read, ie. named pipes.
+	int FeedFile(const char* szFileName)
+	{
+		FILE
+			*pFile;
+
+		char
+			aBuffer[READ_SIZE];
+
+		size_t
+			iRead;
+
+#if defined _WIN32
+		if (fopen_s(&pFile, szFileName, "rb"))
+			return -1;
+#else
+		if (!(pFile = fopen(szFileName, "rb")))
+			return -1;
+#endif
+
+		while ((iRead = fread(aBuffer, sizeof(char), sizeof(aBuffer), pFile)) > 0)
+			Feed(aBuffer, iRead);
+
+		fclose(pFile);
+
+		return Finish();
 	}
 };
 
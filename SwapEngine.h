@@ -0,0 +1,661 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Swap Engine
+
+Everything DoNotCrash does per tick, independent of the game. See World.h for what a world has to provide.
+
+Usage:
+
+- Call SetConfig() after loading the config (and whenever it changes).
+- Call Init() once the world is ready, it picks up all vehicles and peds that already exist.
+- Forward vehicle creation/destruction to OnVehicleCreated()/OnVehicleDestroyed(), same for peds.
+- Call Process() once per tick.
+- Call Shutdown() before the game shuts down, it writes out what the metrics and the swap trace collected.
+
+The player can swap from a vehicle or on foot (a ped) to a vehicle or a ped, as enabled in the SwapTypes section.
+Objects are not supported yet, the ObjectTo* and *ToObject settings have no effect.
+
+Define DNC_METRICS to collect per-tick metrics, see Metrics.h.
+Define DNC_TRACE to record every swap to a file, see SwapTrace.h.
+
+*/// ----------------------------------------------------
+
+#include <math.h>
+#include <vector>
+
+#include "Config.h"
+#include "World.h"
+#include "CandidateIndex.h"
+#include "Cooldown.h"
+#include "PhysicsBudget.h"
+#include "CollisionPredictor.h"
+#include "CollisionQueue.h"
+#include "ModelFilter.h"
+#include "Metrics.h"
+
+#if defined DNC_TRACE
+#include "SwapTrace.h"
+#endif
+
+// ------------------------------------------------------
+
+constexpr unsigned int DRIVER_REFRESH_TICKS = 8; // Inactive entities (ie. vehicles without a driver) are checked again every x ticks
+
+// ------------------------------------------------------
+
+template<typename TWorld>
+class SwapEngine
+{
+private:
+
+	TWorld		&m_World;
+
+	SConfig		m_Config;
+
+	CandidateIndex
+				m_Candidates; // Active = driven vehicles and peds on foot
+	PhysicsBudget
+				m_PhysicsBudget;
+	CollisionPredictor
+				m_CollisionPredictor;
+	CollisionQueue
+				m_CollisionQueue; // Entity IDs, see CandidateIndex.h
+	ModelFilter	m_ModelFilter; // Built from the config
+
+	unsigned int
+				m_aSwapTargets[EntityType::COUNT] = {}; // Per player entity type, EntityType::Bit() of each type it may swap to
+
+	std::vector<int>
+				m_vNearby;
+
+	unsigned int
+				m_iLastSwap = 0;
+
+	CooldownTable
+				m_aSwapBackCooldowns[EntityType::COUNT]; // Entities the player left, see SConfig::iSwapBackDelay
+
+	unsigned int
+				m_iSwapCount = 0;
+
+#if defined DNC_METRICS
+	Metrics		m_Metrics;
+#endif
+
+#if defined DNC_TRACE
+	SwapTrace::Recorder
+				m_Trace;
+	SwapTrace::SSwapRecord
+				m_TraceRecord; // The swap being done, see _BeginTrace()
+
+	std::chrono::steady_clock::time_point
+				m_tWarpStart;
+#endif
+
+	// Entity access by ID, objects are never indexed so they don't need to be handled
+
+	bool _IsActive(int iEntity)
+	{
+		if (GetEntityType(iEntity) == EntityType::VEHICLE)
+			return m_World.GetVehicleDriver(GetEntityIndex(iEntity)) != -1;
+
+		return m_World.GetPedVehicle(GetEntityIndex(iEntity)) == -1;
+	}
+
+	SVector3 _GetPosition(int iEntity)
+	{
+		if (GetEntityType(iEntity) == EntityType::VEHICLE)
+			return m_World.GetVehiclePosition(GetEntityIndex(iEntity));
+
+		return m_World.GetPedPosition(GetEntityIndex(iEntity));
+	}
+
+	SVector3 _GetVelocity(int iEntity)
+	{
+		if (GetEntityType(iEntity) == EntityType::VEHICLE)
+			return m_World.GetVehicleVelocity(GetEntityIndex(iEntity));
+
+		return m_World.GetPedVelocity(GetEntityIndex(iEntity));
+	}
+
+	float _GetBoundRadius(int iEntity)
+	{
+		if (GetEntityType(iEntity) == EntityType::VEHICLE)
+			return m_World.GetVehicleBoundRadius(GetEntityIndex(iEntity));
+
+		return m_World.GetPedBoundRadius(GetEntityIndex(iEntity));
+	}
+
+	float _GetHealth(int iEntity)
+	{
+		if (GetEntityType(iEntity) == EntityType::VEHICLE)
+			return m_World.GetVehicleHealth(GetEntityIndex(iEntity));
+
+		return m_World.GetPedHealth(GetEntityIndex(iEntity));
+	}
+
+	// vecRelPos/vecRelVel: Position and velocity of the entity relative to the player.
+	void _AddContact(int iEntity, int iSource, float fContactTime, const SVector3& vecRelPos, const SVector3& vecRelVel)
+	{
+		CollisionQueue::SContact
+			Contact;
+
+		float
+			fDistance = sqrtf(vecRelPos.MagnitudeSqr());
+
+		Contact.iIndex = iEntity;
+		Contact.iSource = iSource;
+		Contact.fContactTime = fContactTime;
+		Contact.fClosingSpeed = fDistance > 0.0f ? -vecRelPos.Dot(vecRelVel) / fDistance : 0.0f;
+		Contact.fHealth = _GetHealth(iEntity);
+
+		m_CollisionQueue.Add(Contact);
+	}
+
+	// Promotes and demotes what was added to the physics budget since its Begin(). Without candidates everything
+	// that was promoted is released.
+	void _ApplyPhysicsBudget()
+	{
+		m_PhysicsBudget.Apply([this](int i)
+		{
+			if (!m_World.PromoteVehicle(i))
+				return false;
+
+#if defined DNC_METRICS
+			m_Metrics.AddPromoted();
+#endif
+
+			return true;
+		},
+		[this](int i)
+		{
+			m_World.DemoteVehicle(i);
+		});
+	}
+
+	// Demotes all vehicles the budget promoted and returns iResult, for ticks that end before the player's surroundings
+	// are looked at.
+	int _ReleasePhysics(int iResult)
+	{
+		m_PhysicsBudget.Begin();
+		_ApplyPhysicsBudget();
+
+		return iResult;
+	}
+
+	void _StartCooldown(int iEntity, unsigned int iNow)
+	{
+		m_aSwapBackCooldowns[GetEntityType(iEntity)].Start(m_Candidates.GetHandle(iEntity), iNow);
+	}
+
+#if defined DNC_TRACE
+	int _GetModel(int iEntity)
+	{
+		if (GetEntityType(iEntity) == EntityType::VEHICLE)
+			return m_World.GetVehicleModel(GetEntityIndex(iEntity));
+
+		return m_World.GetPedModel(GetEntityIndex(iEntity));
+	}
+
+	// Fills in the record for the swap from iPlayer to iTarget (entity IDs) and starts timing the warps.
+	void _BeginTrace(int iPlayer, int iTarget)
+	{
+		m_TraceRecord = {};
+		m_TraceRecord.iTime = SwapTrace::GetTime();
+		m_TraceRecord.iPlayer = GetEntityIndex(iPlayer);
+		m_TraceRecord.iTarget = GetEntityIndex(iTarget);
+		m_TraceRecord.iPlayerModel = _GetModel(iPlayer);
+		m_TraceRecord.iTargetModel = _GetModel(iTarget);
+		m_TraceRecord.vecPlayerBefore = _GetVelocity(iPlayer);
+		m_TraceRecord.vecTargetBefore = _GetVelocity(iTarget);
+		m_TraceRecord.iPlayerType = (unsigned char)GetEntityType(iPlayer);
+		m_TraceRecord.iTargetType = (unsigned char)GetEntityType(iTarget);
+		m_TraceRecord.bTargetDriver = GetEntityType(iTarget) == EntityType::VEHICLE && m_World.GetVehicleDriver(GetEntityIndex(iTarget)) != -1;
+
+		m_tWarpStart = std::chrono::steady_clock::now();
+	}
+
+	// Call right after the warps, before the velocities are restored.
+	void _EndTrace()
+	{
+		m_TraceRecord.iWarpTime = (unsigned int)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_tWarpStart).count();
+		m_TraceRecord.vecPlayerAfter = _GetVelocity(MakeEntityId(m_TraceRecord.iPlayerType, m_TraceRecord.iPlayer));
+		m_TraceRecord.vecTargetAfter = _GetVelocity(MakeEntityId(m_TraceRecord.iTargetType, m_TraceRecord.iTarget));
+
+		m_Trace.Add(m_TraceRecord);
+	}
+#endif
+
+	// Swaps
+
+	void _SwapVehicleToVehicle(int iPlayerPed, int iPlayerVehicle, int iTargetVehicle, const SVector3& vecPlayerVelocity)
+	{
+		int
+			iTargetPed = m_World.GetVehicleDriver(iTargetVehicle);
+
+		SVector3
+			vecTargetVelocity;
+
+		// Save velocity. When the vehicles are switched they usually lose all of it (requires status to be physics)
+
+		vecTargetVelocity = m_World.GetVehicleVelocity(iTargetVehicle);
+
+		// Remove player from vehicle
+
+		m_World.WarpPedOutOfVehicle(iPlayerPed);
+
+		if (iTargetPed != -1) // If the target vehicle has a driver, remove the ped from vehicle and put them in the player vehicle
+		{
+			m_World.WarpPedOutOfVehicle(iTargetPed);
+			m_World.WarpPedIntoVehicle(iTargetPed, iPlayerVehicle);
+		}
+
+		// Put player in target vehicle
+
+		m_World.WarpPedIntoVehicle(iPlayerPed, iTargetVehicle);
+
+#if defined DNC_TRACE
+		_EndTrace();
+#endif
+
+		// Restore camera
+
+		m_World.RestoreCamera();
+
+		// Restore velocity
+
+		m_World.SetVehicleVelocity(iPlayerVehicle, vecPlayerVelocity);
+		m_World.SetVehicleVelocity(iTargetVehicle, vecTargetVelocity);
+	}
+
+	// The ped takes over the player's vehicle, the player takes the ped's place on foot.
+	void _SwapVehicleToPed(int iPlayerPed, int iPlayerVehicle, int iTargetPed, const SVector3& vecPlayerVelocity)
+	{
+		SVector3
+			vecTargetPos = m_World.GetPedPosition(iTargetPed);
+
+		m_World.WarpPedOutOfVehicle(iPlayerPed);
+		m_World.WarpPedIntoVehicle(iTargetPed, iPlayerVehicle);
+		m_World.SetPedPosition(iPlayerPed, vecTargetPos);
+
+#if defined DNC_TRACE
+		_EndTrace();
+#endif
+
+		m_World.RestoreCamera();
+		m_World.SetVehicleVelocity(iPlayerVehicle, vecPlayerVelocity);
+	}
+
+	// The player takes over the vehicle, its driver (if any) takes the player's place on foot.
+	void _SwapPedToVehicle(int iPlayerPed, int iTargetVehicle)
+	{
+		int
+			iTargetPed = m_World.GetVehicleDriver(iTargetVehicle);
+
+		SVector3
+			vecPlayerPos = m_World.GetPedPosition(iPlayerPed),
+			vecTargetVelocity = m_World.GetVehicleVelocity(iTargetVehicle);
+
+		if (iTargetPed != -1)
+		{
+			m_World.WarpPedOutOfVehicle(iTargetPed);
+			m_World.SetPedPosition(iTargetPed, vecPlayerPos);
+		}
+
+		m_World.WarpPedIntoVehicle(iPlayerPed, iTargetVehicle);
+
+#if defined DNC_TRACE
+		_EndTrace();
+#endif
+
+		m_World.RestoreCamera();
+		m_World.SetVehicleVelocity(iTargetVehicle, vecTargetVelocity);
+	}
+
+	// Only the positions are swapped, the models stay the same.
+	void _SwapPedToPed(int iPlayerPed, int iTargetPed)
+	{
+		SVector3
+			vecPlayerPos = m_World.GetPedPosition(iPlayerPed),
+			vecTargetPos = m_World.GetPedPosition(iTargetPed);
+
+		m_World.SetPedPosition(iPlayerPed, vecTargetPos);
+		m_World.SetPedPosition(iTargetPed, vecPlayerPos);
+
+#if defined DNC_TRACE
+		_EndTrace();
+#endif
+
+		m_World.RestoreCamera();
+	}
+
+	// Returns why the tick ended, see TickResult::
+	int _Process()
+	{
+		int
+			iPlayerPed,
+			iPlayerVehicle,
+			iPlayer,
+			iTarget,
+			iType;
+
+		unsigned int
+			iTargetTypes;
+
+		SVector3
+			vecPlayerPos,
+			vecPlayerVelocity,
+			vecRelPos,
+			vecRelVel;
+
+		float
+			fPlayerRadius,
+			fContactTime;
+
+		size_t
+			iSlotsVisited;
+
+		int
+			iResult = TickResult::NO_COLLISION;
+
+		unsigned int
+			iNow = m_World.GetTime();
+
+		// Check if we even need to do anything. Vehicles promoted before are released, except during the swap delay which
+		// only lasts a few ticks.
+
+		if (!m_Config.bActive)
+			return _ReleasePhysics(TickResult::INACTIVE);
+
+		if (iNow - m_iLastSwap < m_Config.iSwapDelay)
+			return TickResult::DELAY;
+
+		if (!m_World.IsPlayerPlaying())
+			return _ReleasePhysics(TickResult::NOT_PLAYING);
+
+		if (!m_Config.bActiveOnMission && m_World.IsOnMission())
+			return _ReleasePhysics(TickResult::ON_MISSION);
+
+		if (!m_Config.bActiveOnSubmission && m_World.IsMiniGameInProgress())
+			return _ReleasePhysics(TickResult::MINIGAME);
+
+		// Find Player and Vehicle. On foot the player's ped is the entity that swaps.
+
+		iPlayerPed = m_World.GetPlayerPed();
+		iPlayerVehicle = m_World.GetPlayerVehicle();
+
+		if (iPlayerPed == -1 || (iPlayerVehicle != -1 && m_World.GetVehicleDriver(iPlayerVehicle) != iPlayerPed))
+			return _ReleasePhysics(TickResult::NO_VEHICLE);
+
+		iPlayer = iPlayerVehicle != -1 ? MakeEntityId(EntityType::VEHICLE, iPlayerVehicle) : MakeEntityId(EntityType::PED, iPlayerPed);
+		iTargetTypes = m_aSwapTargets[GetEntityType(iPlayer)];
+
+		if (iPlayerVehicle == -1 && !iTargetTypes)
+			return _ReleasePhysics(TickResult::NO_VEHICLE);
+
+		vecPlayerPos = _GetPosition(iPlayer);
+		vecPlayerVelocity = _GetVelocity(iPlayer);
+		fPlayerRadius = _GetBoundRadius(iPlayer);
+
+		// Driven vehicles (for the physics budget) and the entities the player can swap to are put into one index, so a
+		// single query finds the nearby ones. Entities far away are only looked at every few ticks.
+
+		iSlotsVisited = m_Candidates.Update(EntityType::Bit(EntityType::VEHICLE) | iTargetTypes, [this](int iEntity)
+		{
+			return _IsActive(iEntity);
+		},
+		[this](int iEntity)
+		{
+			return _GetPosition(iEntity);
+		}, vecPlayerPos, m_Config.fPhysicsDemoteRadius, iNow, DRIVER_REFRESH_TICKS);
+
+		m_vNearby.clear();
+		m_Candidates.Query(vecPlayerPos, m_Config.fPhysicsDemoteRadius, m_vNearby);
+
+		iSlotsVisited += m_vNearby.size();
+
+#if defined DNC_METRICS
+		m_Metrics.AddSlotsVisited(iSlotsVisited);
+#endif
+
+		m_PhysicsBudget.Begin();
+		m_CollisionPredictor.Begin(m_World.GetTimeStep());
+		m_CollisionQueue.Clear();
+
+		// Collect every contact with the player: The ones the game reported for the player's vehicle, the nearby vehicles
+		// that reported a collision with the player and the entities that are going to touch the player during this frame.
+		// The game only reports collisions after the frame, so predicting them saves a tick of latency. On foot there
+		// are no reports for the player's ped, so predicting is always enabled there.
+
+		if (iPlayerVehicle != -1)
+		{
+			iTarget = m_World.GetVehicleCollision(iPlayerVehicle);
+
+			if (iTarget != -1 && (iTargetTypes & EntityType::Bit(EntityType::VEHICLE)))
+			{
+				iTarget = MakeEntityId(EntityType::VEHICLE, iTarget);
+				_AddContact(iTarget, CollisionSource::REPORTED, 0.0f, _GetPosition(iTarget) - vecPlayerPos, _GetVelocity(iTarget) - vecPlayerVelocity);
+			}
+
+			iTarget = m_World.GetVehicleCollisionPed(iPlayerVehicle);
+
+			if (iTarget != -1 && (iTargetTypes & EntityType::Bit(EntityType::PED)) && m_World.GetPedVehicle(iTarget) == -1)
+			{
+				iTarget = MakeEntityId(EntityType::PED, iTarget);
+				_AddContact(iTarget, CollisionSource::REPORTED, 0.0f, _GetPosition(iTarget) - vecPlayerPos, _GetVelocity(iTarget) - vecPlayerVelocity);
+			}
+		}
+
+		for (int iEntity : m_vNearby)
+		{
+			if (iEntity == iPlayer)
+				continue;
+
+			iType = GetEntityType(iEntity);
+
+			vecRelPos = _GetPosition(iEntity) - vecPlayerPos;
+			vecRelVel = _GetVelocity(iEntity) - vecPlayerVelocity;
+
+			if (iType == EntityType::VEHICLE && iPlayerVehicle != -1)
+				m_PhysicsBudget.AddCandidate(GetEntityIndex(iEntity), vecRelPos.x, vecRelPos.y, vecRelPos.z, vecRelVel.x, vecRelVel.y, vecRelVel.z);
+
+			if (!(iTargetTypes & EntityType::Bit(iType)))
+				continue;
+
+			if (iType == EntityType::VEHICLE && (iPlayerVehicle != -1 ?
+				m_World.GetVehicleCollision(GetEntityIndex(iEntity)) == iPlayerVehicle :
+				m_World.GetVehicleCollisionPed(GetEntityIndex(iEntity)) == iPlayerPed))
+				_AddContact(iEntity, CollisionSource::REPORTED_BY_OTHER, 0.0f, vecRelPos, vecRelVel);
+
+			if (m_Config.bPredictiveSwap || iPlayerVehicle == -1)
+			{
+				fContactTime = m_CollisionPredictor.AddCandidate(vecRelPos.x, vecRelPos.y, vecRelPos.z, vecRelVel.x, vecRelVel.y, vecRelVel.z,
+					fPlayerRadius, _GetBoundRadius(iEntity));
+
+				if (fContactTime >= 0.0f)
+					_AddContact(iEntity, CollisionSource::PREDICTED, fContactTime, vecRelPos, vecRelVel);
+			}
+		}
+
+		// Make driven vehicles near the player's vehicle be fully processed, as many as the budget allows.
+		// On foot there are no candidates, so this releases the ones promoted before.
+
+		_ApplyPhysicsBudget();
+
+		// Pick the target. If every contact is filtered out, the tick ends with the reason of the first one.
+
+		iTarget = m_CollisionQueue.Select(m_Config.iTargetPolicy, [&](const CollisionQueue::SContact& Contact)
+		{
+			int
+				iReason = TickResult::SWAPPED,
+				iContactType = GetEntityType(Contact.iIndex);
+
+			if (m_aSwapBackCooldowns[iContactType].IsActive(m_Candidates.GetHandle(Contact.iIndex), iNow, m_Config.iSwapBackDelay)) // Don't immediately jump back
+				iReason = TickResult::SWAP_BACK;
+			else if (Contact.fHealth <= (iContactType == EntityType::VEHICLE ? 250.0f : 0.0f)) // Don't swap into burning or exploded vehicles or dead peds
+				iReason = TickResult::LOW_HEALTH;
+			else if (iContactType == EntityType::VEHICLE && (!m_ModelFilter.IsAllowed(m_World.GetVehicleModel(GetEntityIndex(Contact.iIndex))) ||
+				(!m_Config.bSwapToMissionVehicles && m_World.IsMissionVehicle(GetEntityIndex(Contact.iIndex)))))
+				iReason = TickResult::FILTERED;
+			else if (iContactType == EntityType::PED && (!m_ModelFilter.IsAllowed(m_World.GetPedModel(GetEntityIndex(Contact.iIndex))) ||
+				(!m_Config.bSwapToMissionPeds && m_World.IsMissionPed(GetEntityIndex(Contact.iIndex)))))
+				iReason = TickResult::FILTERED;
+
+			if (iReason != TickResult::SWAPPED && iResult == TickResult::NO_COLLISION)
+				iResult = iReason;
+
+			return iReason == TickResult::SWAPPED;
+		});
+
+		if (iTarget == -1)
+			return iResult;
+
+		// Do the thing. The entity the player leaves behind gets a cooldown, so the next contact with it doesn't swap back.
+
+		m_iLastSwap = iNow;
+		++m_iSwapCount;
+
+#if defined DNC_METRICS
+		m_Metrics.AddSwap();
+#endif
+
+#if defined DNC_TRACE
+		_BeginTrace(iPlayer, iTarget);
+#endif
+
+		if (iPlayerVehicle != -1)
+		{
+			_StartCooldown(iPlayer, iNow);
+
+			if (GetEntityType(iTarget) == EntityType::VEHICLE)
+				_SwapVehicleToVehicle(iPlayerPed, iPlayerVehicle, GetEntityIndex(iTarget), vecPlayerVelocity);
+			else
+				_SwapVehicleToPed(iPlayerPed, iPlayerVehicle, GetEntityIndex(iTarget), vecPlayerVelocity);
+		}
+		else if (GetEntityType(iTarget) == EntityType::VEHICLE)
+		{
+			if (m_World.GetVehicleDriver(GetEntityIndex(iTarget)) != -1)
+				_StartCooldown(MakeEntityId(EntityType::PED, m_World.GetVehicleDriver(GetEntityIndex(iTarget))), iNow);
+
+			_SwapPedToVehicle(iPlayerPed, GetEntityIndex(iTarget));
+		}
+		else
+		{
+			_StartCooldown(iTarget, iNow);
+			_SwapPedToPed(iPlayerPed, GetEntityIndex(iTarget));
+		}
+
+		return TickResult::SWAPPED;
+	}
+
+public:
+
+	SwapEngine(TWorld& World) :
+		m_World(World)
+	{
+
+	}
+
+	void SetConfig(const SConfig& Config)
+	{
+		m_Config = Config;
+
+		m_PhysicsBudget.SetLimits(m_Config.iMaxPhysicsVehicles, m_Config.fPhysicsRadius);
+		m_CollisionPredictor.SetRadiusScale(m_Config.fPredictRadiusScale);
+		m_ModelFilter.Build(m_Config.aAllowedModels, MODEL_LIST_SIZE, m_Config.aBlockedModels, MODEL_LIST_SIZE);
+
+		// Objects can't be controlled yet, so swaps from and to them are left out
+
+		m_aSwapTargets[EntityType::VEHICLE] =
+			(m_Config.bVehicleToVehicle ? EntityType::Bit(EntityType::VEHICLE) : 0) |
+			(m_Config.bVehicleToPed ? EntityType::Bit(EntityType::PED) : 0);
+
+		m_aSwapTargets[EntityType::PED] =
+			(m_Config.bPedToVehicle ? EntityType::Bit(EntityType::VEHICLE) : 0) |
+			(m_Config.bPedToPed ? EntityType::Bit(EntityType::PED) : 0);
+
+		m_aSwapTargets[EntityType::OBJECT] = 0;
+	}
+
+	const SConfig& GetConfig() const
+	{
+		return m_Config;
+	}
+
+	void Init()
+	{
+		m_iLastSwap = m_World.GetTime();
+
+#if defined DNC_TRACE
+		m_Trace.Start(SWAP_TRACE_FILE);
+#endif
+
+		// Pick up vehicles and peds that were created before the events were added
+
+		for (int i = 0; i < m_World.GetVehiclePoolSize(); ++i)
+			if (m_World.IsVehicleSlotUsed(i))
+				m_Candidates.OnCreated(EntityType::VEHICLE, i);
+
+		for (int i = 0; i < m_World.GetPedPoolSize(); ++i)
+			if (m_World.IsPedSlotUsed(i))
+				m_Candidates.OnCreated(EntityType::PED, i);
+	}
+
+	void OnVehicleCreated(int iVehicle)
+	{
+		m_Candidates.OnCreated(EntityType::VEHICLE, iVehicle);
+	}
+
+	void OnVehicleDestroyed(int iVehicle)
+	{
+		m_Candidates.OnDestroyed(EntityType::VEHICLE, iVehicle);
+		m_PhysicsBudget.OnDestroyed(iVehicle);
+	}
+
+	void OnPedCreated(int iPed)
+	{
+		m_Candidates.OnCreated(EntityType::PED, iPed);
+	}
+
+	void OnPedDestroyed(int iPed)
+	{
+		m_Candidates.OnDestroyed(EntityType::PED, iPed);
+	}
+
+	unsigned int GetSwapCount() const
+	{
+		return m_iSwapCount;
+	}
+
+	void Process()
+	{
+#if defined DNC_METRICS
+		m_Metrics.BeginTick();
+		m_Metrics.EndTick(_Process());
+#else
+		_Process();
+#endif
+	}
+
+	// Waits for the background writers, see Metrics::Stop() and SwapTrace::Recorder::Stop().
+	void Shutdown()
+	{
+#if defined DNC_METRICS
+		m_Metrics.Stop();
+#endif
+
+#if defined DNC_TRACE
+		m_Trace.Stop();
+#endif
+	}
+
+#if defined DNC_METRICS
+	Metrics& GetMetrics()
+	{
+		return m_Metrics;
+	}
+#endif
+};
+
+// ------------------------------------------------------
@@ -0,0 +1,201 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+Swap Trace
+
+Records every swap (from and to vehicles and peds) into a binary file, so swaps that went wrong or took too long can be
+looked at afterwards. tools/SwapTraceDecode.cpp summarizes a trace file.
+
+The game thread only copies a fixed size record into a lock-free ring buffer (see SpscRing.h). A writer thread
+drains it every FLUSH_INTERVAL ms and does all the file I/O, so the game thread never waits for the disk. If the
+writer falls behind by more than RING_SIZE records, new records are dropped. Every record has a sequence number,
+so the decoder can tell how many went missing.
+
+File format: SHeader, then SSwapRecord until the end of the file.
+
+Usage:
+
+- Call Start() once, Add() for each swap.
+- Stop() waits for the writer thread to write what's left and close the file, so the trace is complete once it
+  returned. Call it on game shutdown, see BackgroundWorker.h.
+
+*/// ----------------------------------------------------
+
+#include <stdio.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "World.h"
+#include "BackgroundWorker.h"
+#include "SpscRing.h"
+
+// ------------------------------------------------------
+
+#define SWAP_TRACE_FILE "DoNotCrash.swaps.trace"
+
+namespace SwapTrace
+{
+	constexpr unsigned int MAGIC = 0x54434E44; // "DNCT"
+	constexpr unsigned int VERSION = 2; // 2: Entity types, swaps from and to peds
+
+	constexpr unsigned int RING_SIZE = 1024; // Records
+	constexpr unsigned int FLUSH_INTERVAL = 250; // ms
+
+	struct SHeader
+	{
+		unsigned int
+					iMagic,
+					iVersion,
+					iRecordSize,
+					iReserved;
+	};
+
+	struct SSwapRecord
+	{
+		unsigned long long
+					iTime; // Microseconds, steady clock
+
+		unsigned int
+					iSequence, // Counts up by one per swap, gaps are dropped records
+					iWarpTime; // Nanoseconds spent in the warp commands
+
+		int			iPlayer, // Pool index of the vehicle or ped the player was, see iPlayerType
+					iTarget, // Pool index of the vehicle or ped the player became, see iTargetType
+					iPlayerModel,
+					iTargetModel;
+
+		SVector3	vecPlayerBefore,
+					vecTargetBefore,
+					vecPlayerAfter, // After the warps, before the velocities are restored
+					vecTargetAfter;
+
+		unsigned char
+					bTargetDriver, // The target was a vehicle with a driver, who took the player's place
+					iPlayerType, // EntityType:: (see CandidateIndex.h), 0 = vehicle, 1 = ped
+					iTargetType,
+					aReserved[5];
+	};
+
+	static_assert(sizeof(SSwapRecord) == 88, "SSwapRecord is part of the file format");
+
+	inline unsigned long long GetTime()
+	{
+		return (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// ------------------------------------------------------
+
+	class Recorder
+	{
+	private:
+
+		using RecordRing = SpscRing<SSwapRecord, RING_SIZE>;
+
+		std::shared_ptr<RecordRing>
+					m_pRing; // Owned by the writer as well, see BackgroundWorker.h
+
+		BackgroundWorker
+					m_Writer;
+
+		unsigned int
+					m_iSequence = 0;
+
+		static void _Write(RecordRing& Ring, const std::string& FileName, const BackgroundWorker::Token& Token)
+		{
+			SHeader
+				Header = { MAGIC, VERSION, (unsigned int)sizeof(SSwapRecord), 0 };
+
+			SSwapRecord
+				aRecords[64];
+
+			FILE
+				*pFile;
+
+			size_t
+				iCount;
+
+			bool
+				bRunning;
+
+#if defined _WIN32
+			if (fopen_s(&pFile, FileName.c_str(), "wb"))
+				pFile = nullptr;
+#else
+			pFile = fopen(FileName.c_str(), "wb");
+#endif
+
+			if (pFile)
+				fwrite(&Header, sizeof(Header), 1, pFile);
+
+			// Records are still drained without a file, so the ring doesn't stay full
+
+			do
+			{
+				bRunning = Token.Sleep(FLUSH_INTERVAL);
+
+				while ((iCount = Ring.Pop(aRecords, sizeof(aRecords) / sizeof(aRecords[0]))) != 0)
+					if (pFile)
+						fwrite(aRecords, sizeof(SSwapRecord), iCount, pFile);
+
+				if (pFile)
+					fflush(pFile);
+			}
+			while (bRunning);
+
+			if (pFile)
+				fclose(pFile);
+		}
+
+	public:
+
+		Recorder()
+		{
+
+		}
+
+		Recorder(const Recorder&) = delete;
+		Recorder& operator=(const Recorder&) = delete;
+
+		// Truncates the file and starts the writer thread. The file is opened on the writer thread.
+		void Start(const char* szFileName)
+		{
+			Stop();
+
+			m_pRing = std::make_shared<RecordRing>();
+			m_iSequence = 0;
+
+			m_Writer.Start([pRing = m_pRing, FileName = std::string(szFileName)](const BackgroundWorker::Token& Token)
+			{
+				_Write(*pRing, FileName, Token);
+			});
+		}
+
+		// Waits for the writer thread to write what's left and close the file.
+		void Stop()
+		{
+			m_Writer.Stop();
+			m_pRing.reset();
+		}
+
+		bool IsRunning() const
+		{
+			return m_pRing != nullptr;
+		}
+
+		// Fills in the sequence number. Never blocks, returns false if the record was dropped.
+		bool Add(SSwapRecord& Record)
+		{
+			if (!m_pRing)
+				return false;
+
+			Record.iSequence = m_iSequence++;
+
+			return m_pRing->Push(Record);
+		}
+	};
+}
+
+// ------------------------------------------------------
@@ -0,0 +1,115 @@
+#pragma once
+
+/* ------------------------------------------------------
+
+World
+
+Types shared between the swap engine and the worlds it runs in.
+
+A world is the interface between SwapEngine and the game (GameWorld) or a simulation (SimWorld).
+SwapEngine is a template on the world type, so there is no virtual dispatch in the per-vehicle loops.
+
+Entities are referenced by their pool index, -1 means none.
+A world type must provide the following members:
+
+	// Clock
+
+	unsigned int GetTime();							// Milliseconds, may wrap around
+	float GetTimeStep();							// Length of the current frame in velocity units (1.0 = 1/50 s for GTA)
+
+	// Game state
+
+	bool IsPlayerPlaying();
+	bool IsOnMission();
+	bool IsMiniGameInProgress();
+
+	int GetPlayerPed();
+	int GetPlayerVehicle();							// Vehicle the player is in, -1 if on foot
+
+	// Vehicle pool
+
+	int GetVehiclePoolSize();
+	bool IsVehicleSlotUsed(int iVehicle);
+
+	SVector3 GetVehiclePosition(int iVehicle);
+	SVector3 GetVehicleVelocity(int iVehicle);
+	void SetVehicleVelocity(int iVehicle, const SVector3& vecVelocity);
+	float GetVehicleBoundRadius(int iVehicle);
+	float GetVehicleHealth(int iVehicle);
+	int GetVehicleModel(int iVehicle);
+	bool IsMissionVehicle(int iVehicle);			// Created by a mission script
+	int GetVehicleDriver(int iVehicle);				// Ped index or -1
+	int GetVehicleCollision(int iVehicle);			// Vehicle it last collided with or -1
+	int GetVehicleCollisionPed(int iVehicle);		// Ped it last collided with or -1
+
+	bool PromoteVehicle(int iVehicle);				// Switch to full physics, false if it wasn't using simple processing
+	void DemoteVehicle(int iVehicle);				// Switch back to simple processing
+
+	// Ped pool
+
+	int GetPedPoolSize();
+	bool IsPedSlotUsed(int iPed);
+
+	SVector3 GetPedPosition(int iPed);
+	void SetPedPosition(int iPed, const SVector3& vecPos);
+	SVector3 GetPedVelocity(int iPed);
+	float GetPedBoundRadius(int iPed);
+	float GetPedHealth(int iPed);
+	int GetPedModel(int iPed);
+	bool IsMissionPed(int iPed);					// Created by a mission script
+	int GetPedVehicle(int iPed);					// Vehicle the ped is in, -1 if on foot
+
+	// Swapping
+
+	void WarpPedOutOfVehicle(int iPed);
+	void WarpPedIntoVehicle(int iPed, int iVehicle);
+	void RestoreCamera();
+
+*/// ----------------------------------------------------
+
+struct SVector3
+{
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+
+	SVector3()
+	{
+
+	}
+
+	SVector3(float fX, float fY, float fZ) :
+		x(fX),
+		y(fY),
+		z(fZ)
+	{
+
+	}
+
+	SVector3 operator-(const SVector3& vec) const
+	{
+		return SVector3(x - vec.x, y - vec.y, z - vec.z);
+	}
+
+	SVector3 operator+(const SVector3& vec) const
+	{
+		return SVector3(x + vec.x, y + vec.y, z + vec.z);
+	}
+
+	SVector3 operator*(float f) const
+	{
+		return SVector3(x * f, y * f, z * f);
+	}
+
+	float MagnitudeSqr() const
+	{
+		return x * x + y * y + z * z;
+	}
+
+	float Dot(const SVector3& vec) const
+	{
+		return x * vec.x + y * vec.y + z * vec.z;
+	}
+};
+
+// ------------------------------------------------------
@@ -0,0 +1,75 @@
+#pragma once
+
+// ---------------------------------------------------------
+/*
+
+    AllocCounter
+
+    Replaces the global operator new/delete to count every
+    heap allocation of the program, see GetAllocationCount().
+    The replacements are real definitions, so only include
+    this in the one source file of a tool.
+
+*/
+// ---------------------------------------------------------
+
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+// GCC sees malloc/free through the inlined replacements and warns about new/delete mismatches that aren't there
+#if defined __GNUC__ && !defined __clang__ && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// ---------------------------------------------------------
+
+inline std::atomic<size_t>& GetAllocationCount()
+{
+    static std::atomic<size_t>
+        s_iCount(0);
+
+    return s_iCount;
+}
+
+void* operator new(size_t iSize)
+{
+    void
+        *p;
+
+    ++GetAllocationCount();
+
+    p = malloc(iSize ? iSize : 1);
+
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void* operator new[](size_t iSize)
+{
+    return operator new(iSize);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+// ---------------------------------------------------------
@@ -0,0 +1,150 @@
+#pragma once
+
+// ---------------------------------------------------------
+/*
+
+    Bench
+
+    Small helpers shared by the benchmarks and tests in
+    this directory: a stopwatch, a deterministic random
+    generator, a CHECK macro that counts failures and a
+    CPU feature check for the SIMD variants.
+
+*/
+// ---------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#if defined _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------
+
+class Stopwatch
+{
+private:
+
+    std::chrono::steady_clock::time_point
+        m_Start;
+
+public:
+
+    Stopwatch()
+    {
+        Restart();
+    }
+
+    void Restart()
+    {
+        m_Start = std::chrono::steady_clock::now();
+    }
+
+    double GetMicroseconds() const
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_Start).count();
+    }
+};
+
+// ---------------------------------------------------------
+
+// xorshift32, the same sequence on every platform.
+class Random
+{
+private:
+
+    unsigned int
+        m_iState;
+
+public:
+
+    Random(unsigned int iSeed = 0x12345678)
+    {
+        m_iState = iSeed ? iSeed : 1;
+    }
+
+    unsigned int Next()
+    {
+        m_iState ^= m_iState << 13;
+        m_iState ^= m_iState >> 17;
+        m_iState ^= m_iState << 5;
+
+        return m_iState;
+    }
+
+    // [iMin, iMax]
+    int Int(int iMin, int iMax)
+    {
+        return iMin + (int)(Next() % (unsigned int)(iMax - iMin + 1));
+    }
+
+    // [fMin, fMax]
+    float Float(float fMin, float fMax)
+    {
+        return fMin + (fMax - fMin) * (float)(Next() & 0xFFFFFF) / (float)0xFFFFFF;
+    }
+};
+
+// ---------------------------------------------------------
+
+// Prevents the compiler from dropping a result that is only computed for timing.
+template<typename T>
+inline void KeepResult(const T& Value)
+{
+    static volatile T
+        s_Sink;
+
+    s_Sink = Value;
+    (void)s_Sink;
+}
+
+// ---------------------------------------------------------
+
+// Tests report failures through CHECK and return GetFailureCount() != 0 from main.
+
+inline int& GetFailureCount()
+{
+    static int
+        s_iFailures = 0;
+
+    return s_iFailures;
+}
+
+#define CHECK(x) \
+    do \
+    { \
+        if (!(x)) \
+        { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #x); \
+            ++GetFailureCount(); \
+        } \
+    } while (0)
+
+// ---------------------------------------------------------
+
+// True if the CPU (and OS) can run AVX2 code, so a variant built with AVX2 can skip itself instead of crashing.
+inline bool IsAVX2Supported()
+{
+#if defined _MSC_VER && (defined _M_X64 || defined _M_IX86)
+    int
+        aInfo[4];
+
+    __cpuid(aInfo, 1);
+
+    if (!(aInfo[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) // OSXSAVE, XMM and YMM state enabled
+        return false;
+
+    __cpuidex(aInfo, 7, 0);
+
+    return (aInfo[1] & (1 << 5)) != 0;
+#elif defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// ---------------------------------------------------------
@@ -0,0 +1,261 @@
+// ---------------------------------------------------------
+/*
+
+    CandidateBench
+
+    Compares finding the driven vehicles near the player
+    through CandidateIndex with the linear pool scan the
+    plugin used before (every slot, square root distance),
+    at pool sizes from 110 (the default vehicle pool) to
+    10000. Vehicles and the player move every tick, so the
+    index is updated every tick like in SwapEngine. Memory is laid out like the game's pool:
+    the used flags are a byte array of their own, every
+    slot is as big as a vehicle and the position is in a
+    matrix the slot points to, so both touch memory like
+    they do in the game.
+
+    Also checks that both find the same vehicles, the exit
+    code is 1 if they don't.
+
+    Usage: CandidateBench [ticks]
+
+*/
+// ---------------------------------------------------------
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include "../CandidateIndex.h"
+#include "Bench.h"
+
+static constexpr float
+    QUERY_RADIUS = 60.0f, // Same as SConfig::fPhysicsDemoteRadius
+    AREA_SIZE = 1000.0f; // Vehicles only exist around the player
+
+static constexpr size_t
+    POOL_ENTRY_SIZE = 2584; // sizeof(CAutomobile) in SA, each slot in the pool is this big
+
+static constexpr unsigned int
+    REFRESH_TICKS = 8, // Same as DRIVER_REFRESH_TICKS
+    TICK_MS = 20;
+
+// CMatrix, allocated separately from the entity like in the game
+struct SBenchMatrix
+{
+    float       aRotation[12];
+    float       fX, fY, fZ;
+    float       fPadding;
+};
+
+struct SBenchVehicle
+{
+    SBenchMatrix
+                *pMatrix;
+
+    bool        bDriven; // m_pDriver != nullptr
+
+    float       fVX, fVY;
+
+    char        aPadding[POOL_ENTRY_SIZE - sizeof(SBenchMatrix*) - 3 * sizeof(float)];
+};
+
+struct SBenchPool
+{
+    std::vector<unsigned char>
+                vUsed; // CPool::m_byteMap
+
+    std::vector<SBenchVehicle>
+                vVehicles;
+
+    std::vector<SBenchMatrix>
+                vMatrices;
+};
+
+// The old loop from processScriptsEvent, over plain structs instead of CPools.
+static void LinearScan(const SBenchPool& Pool, const SVector3& vecPlayer, std::vector<int>& vResult)
+{
+    const SBenchMatrix
+        *pMatrix;
+
+    float
+        fDX,
+        fDY,
+        fDZ;
+
+    vResult.clear();
+
+    for (size_t i = 0; i < Pool.vVehicles.size(); ++i)
+    {
+        if (!Pool.vUsed[i] || !Pool.vVehicles[i].bDriven)
+            continue;
+
+        pMatrix = Pool.vVehicles[i].pMatrix;
+
+        fDX = pMatrix->fX - vecPlayer.x;
+        fDY = pMatrix->fY - vecPlayer.y;
+        fDZ = pMatrix->fZ - vecPlayer.z;
+
+        if (sqrtf(fDX * fDX + fDY * fDY + fDZ * fDZ) > QUERY_RADIUS)
+            continue;
+
+        vResult.push_back((int)i);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    static const int
+        s_aPoolSizes[] = { 110, 500, 1000, 2000, 5000, 10000 };
+
+    int
+        iTicks = argc > 1 ? atoi(argv[1]) : 1000;
+
+    bool
+        bMismatch = false;
+
+    if (iTicks <= 0)
+        iTicks = 1;
+
+    printf("%d ticks per pool size, radius %.0f\n\n", iTicks, QUERY_RADIUS);
+    printf("%6s %7s %6s %11s %11s %8s\n", "pool", "driven", "found", "linear us", "index us", "speedup");
+
+    for (int iPoolSize : s_aPoolSizes)
+    {
+        Random
+            Rand((unsigned int)iPoolSize);
+
+        SBenchPool
+            Pool;
+
+        std::vector<int>
+            vLinear,
+            vIndex;
+
+        CandidateIndex
+            Index;
+
+        Stopwatch
+            Timer;
+
+        double
+            dLinear = 0.0,
+            dIndex = 0.0;
+
+        size_t
+            iDriven = 0,
+            iFound = 0;
+
+        SVector3
+            vecPlayer;
+
+        float
+            fPlayerVX = 1.0f;
+
+        auto fnIsDriven = [&](int iEntity)
+        {
+            return Pool.vVehicles[GetEntityIndex(iEntity)].bDriven;
+        };
+
+        auto fnGetPosition = [&](int iEntity)
+        {
+            const SBenchMatrix
+                *pMatrix = Pool.vVehicles[GetEntityIndex(iEntity)].pMatrix;
+
+            return SVector3(pMatrix->fX, pMatrix->fY, pMatrix->fZ);
+        };
+
+        Pool.vUsed.resize((size_t)iPoolSize);
+        Pool.vVehicles.resize((size_t)iPoolSize);
+        Pool.vMatrices.resize((size_t)iPoolSize);
+
+        for (size_t i = 0; i < Pool.vVehicles.size(); ++i)
+        {
+            SBenchVehicle
+                &Vehicle = Pool.vVehicles[i];
+
+            Pool.vUsed[i] = Rand.Int(0, 9) < 8;
+
+            Vehicle.pMatrix = &Pool.vMatrices[i];
+            Vehicle.bDriven = Pool.vUsed[i] && Rand.Int(0, 9) < 6;
+            Vehicle.pMatrix->fX = Rand.Float(-AREA_SIZE * 0.5f, AREA_SIZE * 0.5f);
+            Vehicle.pMatrix->fY = Rand.Float(-AREA_SIZE * 0.5f, AREA_SIZE * 0.5f);
+            Vehicle.pMatrix->fZ = Rand.Float(-5.0f, 5.0f);
+            Vehicle.fVX = Rand.Float(-1.0f, 1.0f);
+            Vehicle.fVY = Rand.Float(-1.0f, 1.0f);
+
+            if (Pool.vUsed[i])
+                Index.OnCreated(EntityType::VEHICLE, (int)i);
+
+            if (Vehicle.bDriven)
+                ++iDriven;
+        }
+
+        // Let the tracker find all driven vehicles before timing
+
+        for (unsigned int i = 0; i < REFRESH_TICKS; ++i)
+            Index.Update(EntityType::Bit(EntityType::VEHICLE), fnIsDriven, fnGetPosition, vecPlayer, QUERY_RADIUS, 0, REFRESH_TICKS);
+
+        for (int iTick = 0; iTick < iTicks; ++iTick)
+        {
+            vecPlayer.x += fPlayerVX;
+
+            if (fabsf(vecPlayer.x) > AREA_SIZE * 0.25f)
+                fPlayerVX = -fPlayerVX;
+
+            for (auto &Vehicle : Pool.vVehicles)
+            {
+                Vehicle.pMatrix->fX += Vehicle.fVX;
+                Vehicle.pMatrix->fY += Vehicle.fVY;
+
+                if (fabsf(Vehicle.pMatrix->fX) > AREA_SIZE * 0.5f)
+                    Vehicle.fVX = -Vehicle.fVX;
+
+                if (fabsf(Vehicle.pMatrix->fY) > AREA_SIZE * 0.5f)
+                    Vehicle.fVY = -Vehicle.fVY;
+            }
+
+            Timer.Restart();
+            LinearScan(Pool, vecPlayer, vLinear);
+            dLinear += Timer.GetMicroseconds();
+
+            Timer.Restart();
+
+            Index.Update(EntityType::Bit(EntityType::VEHICLE), fnIsDriven, fnGetPosition, vecPlayer, QUERY_RADIUS,
+                (unsigned int)(iTick + 1) * TICK_MS, REFRESH_TICKS);
+
+            vIndex.clear();
+            Index.Query(vecPlayer, QUERY_RADIUS, vIndex);
+
+            dIndex += Timer.GetMicroseconds();
+
+            iFound += vLinear.size();
+
+            for (int &iEntity : vIndex)
+                iEntity = GetEntityIndex(iEntity);
+
+            std::sort(vIndex.begin(), vIndex.end());
+
+            if (vIndex != vLinear && !bMismatch)
+            {
+                printf("pool %d tick %d: index found %zu vehicles, linear scan %zu\n", iPoolSize, iTick, vIndex.size(), vLinear.size());
+                bMismatch = true;
+            }
+        }
+
+        printf("%6d %7zu %6.1f %11.2f %11.2f %7.1fx\n", iPoolSize, iDriven, (double)iFound / iTicks,
+            dLinear / iTicks, dIndex / iTicks, dLinear / dIndex);
+    }
+
+    if (bMismatch)
+    {
+        printf("\nFAILED: index and linear scan disagree\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+// ---------------------------------------------------------
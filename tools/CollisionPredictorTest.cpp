@@ -0,0 +1,138 @@
+// ---------------------------------------------------------
+/*
+
+    CollisionPredictorTest
+
+    Checks SweptSphereTimeToContact() against times worked
+    out by hand: head-on and diagonal approaches, parallel
+    and diverging movement, spheres that already overlap
+    (closing in, moving apart, standing still) and paths
+    that touch exactly, miss or hit by a small epsilon.
+    Also checks CollisionPredictor's horizon and radius
+    scale.
+
+    The exit code is 1 if anything fails.
+
+*/
+// ---------------------------------------------------------
+
+#include <math.h>
+#include <stdio.h>
+
+#include "../CollisionPredictor.h"
+#include "Bench.h"
+
+static constexpr float
+    EPSILON = 0.001f;
+
+static bool IsNear(float fValue, float fExpected)
+{
+    return fabsf(fValue - fExpected) <= 0.0001f * (1.0f + fabsf(fExpected));
+}
+
+static void TestHeadOn()
+{
+    // Centers 10 apart closing in at 2, touching at a distance of 2
+
+    CHECK(IsNear(SweptSphereTimeToContact(10.0f, 0.0f, 0.0f, -2.0f, 0.0f, 0.0f, 2.0f), 4.0f));
+    CHECK(IsNear(SweptSphereTimeToContact(0.0f, -10.0f, 0.0f, 0.0f, 2.0f, 0.0f, 2.0f), 4.0f));
+    CHECK(IsNear(SweptSphereTimeToContact(0.0f, 0.0f, 10.0f, 0.0f, 0.0f, -2.0f, 2.0f), 4.0f));
+
+    // 3-4-12 triangle, 13 apart closing in at 2 along the line between them
+
+    CHECK(IsNear(SweptSphereTimeToContact(3.0f, 4.0f, 12.0f, -6.0f / 13.0f, -8.0f / 13.0f, -24.0f / 13.0f, 1.0f), 6.0f));
+}
+
+static void TestParallel()
+{
+    // Side by side, same direction and speed (no relative velocity) or passing each other at a distance
+
+    CHECK(SweptSphereTimeToContact(0.0f, 5.0f, 0.0f, 0.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+    CHECK(SweptSphereTimeToContact(0.0f, 5.0f, 0.0f, 3.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+    CHECK(SweptSphereTimeToContact(-10.0f, 5.0f, 0.0f, 3.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+}
+
+static void TestOverlapping()
+{
+    // Closing in counts right away, moving apart or standing still doesn't
+
+    CHECK(SweptSphereTimeToContact(1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 2.0f) == 0.0f);
+    CHECK(SweptSphereTimeToContact(1.0f, 1.0f, 0.0f, -0.1f, 0.0f, 0.0f, 2.0f) == 0.0f);
+    CHECK(SweptSphereTimeToContact(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+    CHECK(SweptSphereTimeToContact(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+
+    // Same center: no direction to close in from
+
+    CHECK(SweptSphereTimeToContact(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+}
+
+static void TestDiverging()
+{
+    CHECK(SweptSphereTimeToContact(10.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+    CHECK(SweptSphereTimeToContact(10.0f, 10.0f, 0.0f, 1.0f, -0.5f, 0.0f, 2.0f) == -1.0f);
+
+    // Perpendicular to the line between them, the distance only grows
+
+    CHECK(SweptSphereTimeToContact(10.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 2.0f) == -1.0f);
+}
+
+static void TestEpsilon()
+{
+    float
+        fOffset = 2.0f - EPSILON;
+
+    // Passing at a distance of exactly the radius touches once, at the closest point
+
+    CHECK(IsNear(SweptSphereTimeToContact(10.0f, 2.0f, 0.0f, -1.0f, 0.0f, 0.0f, 2.0f), 10.0f));
+
+    // Missing by an epsilon never touches, hitting by one touches shortly before the closest point
+
+    CHECK(SweptSphereTimeToContact(10.0f, 2.0f + EPSILON, 0.0f, -1.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+    CHECK(SweptSphereTimeToContact(10.0f, 0.0f, 2.0f + EPSILON, -1.0f, 0.0f, 0.0f, 2.0f) == -1.0f);
+    CHECK(IsNear(SweptSphereTimeToContact(10.0f, fOffset, 0.0f, -1.0f, 0.0f, 0.0f, 2.0f), 10.0f - sqrtf(4.0f - fOffset * fOffset)));
+
+    // Starting an epsilon further away touches an epsilon later
+
+    CHECK(IsNear(SweptSphereTimeToContact(4.0f + EPSILON, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 2.0f), 2.0f + EPSILON));
+}
+
+static void TestPredictor()
+{
+    CollisionPredictor
+        Predictor;
+
+    Predictor.Begin(1.0f);
+
+    // Contact at 4, 0.5 and right away, with a horizon of 1
+
+    CHECK(Predictor.AddCandidate(10.0f, 0.0f, 0.0f, -2.0f, 0.0f, 0.0f, 1.0f, 1.0f) == -1.0f);
+    CHECK(IsNear(Predictor.AddCandidate(3.0f, 0.0f, 0.0f, -2.0f, 0.0f, 0.0f, 1.0f, 1.0f), 0.5f));
+    CHECK(Predictor.AddCandidate(1.0f, 0.0f, 0.0f, -2.0f, 0.0f, 0.0f, 1.0f, 1.0f) == 0.0f);
+
+    Predictor.Begin(5.0f);
+
+    CHECK(IsNear(Predictor.AddCandidate(10.0f, 0.0f, 0.0f, -2.0f, 0.0f, 0.0f, 1.0f, 1.0f), 4.0f));
+
+    // Half the radius: touching at a distance of 1
+
+    Predictor.SetRadiusScale(0.5f);
+
+    CHECK(IsNear(Predictor.AddCandidate(10.0f, 0.0f, 0.0f, -2.0f, 0.0f, 0.0f, 1.0f, 1.0f), 4.5f));
+    CHECK(Predictor.AddCandidate(10.0f, 1.5f, 0.0f, -2.0f, 0.0f, 0.0f, 1.0f, 1.0f) == -1.0f);
+}
+
+int main()
+{
+    TestHeadOn();
+    TestParallel();
+    TestOverlapping();
+    TestDiverging();
+    TestEpsilon();
+    TestPredictor();
+
+    printf("CollisionPredictor: %s\n", GetFailureCount() ? "FAILED" : "passed");
+
+    return GetFailureCount() ? 1 : 0;
+}
+
+// ---------------------------------------------------------
@@ -0,0 +1,112 @@
+// ---------------------------------------------------------
+/*
+
+    DistanceFilterBench
+
+    Times FilterByDistance() against the scalar version
+    over synthetic position arrays of different sizes,
+    with about 10% of the positions in range.
+
+    FilterByDistance() picks its version at compile time,
+    CMakeLists.txt builds this once each for SSE2, AVX2 and
+    scalar, the bench target runs all of them.
+
+    Usage: DistanceFilterBench [positions per size]
+    Each size is repeated until about that many positions
+    were checked (default 50000000).
+
+*/
+// ---------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "../DistanceFilter.h"
+#include "Bench.h"
+
+typedef size_t (*FilterFunction)(const float*, const float*, const float*, const int*, size_t, float, float, float, float, std::vector<int>&);
+
+// Returns ns per position.
+static double Time(FilterFunction fnFilter, const std::vector<float>& vX, const std::vector<float>& vY, const std::vector<float>& vZ,
+    const std::vector<int>& vIndex, size_t iRepeat)
+{
+    std::vector<int>
+        vResult;
+
+    Stopwatch
+        Timer;
+
+    size_t
+        iFound = 0;
+
+    vResult.reserve(vX.size());
+
+    for (size_t i = 0; i < iRepeat; ++i)
+    {
+        vResult.clear();
+        iFound += fnFilter(vX.data(), vY.data(), vZ.data(), vIndex.data(), vX.size(), 0.0f, 0.0f, 0.0f, 40.0f * 40.0f, vResult);
+    }
+
+    KeepResult(iFound);
+
+    return Timer.GetMicroseconds() * 1000.0 / (double)(iRepeat * vX.size());
+}
+
+int main(int argc, char* argv[])
+{
+    static const size_t
+        s_aCounts[] = { 8, 61, 512, 4096, 32768 };
+
+    double
+        dPositions = argc > 1 ? atof(argv[1]) : 50000000.0,
+        dFast,
+        dScalar;
+
+#if defined DNC_SIMD_AVX2
+    if (!IsAVX2Supported())
+    {
+        printf("AVX2 not supported by this CPU, skipped\n");
+        return 0;
+    }
+#endif
+
+    printf("FilterByDistance (%s) vs. FilterByDistanceScalar\n", GetDistanceFilterVersion());
+    printf("%9s %12s %12s %8s\n", "positions", "ns/pos", "scalar", "speedup");
+
+    for (size_t iCount : s_aCounts)
+    {
+        Random
+            Rand((unsigned int)iCount);
+
+        std::vector<float>
+            vX(iCount),
+            vY(iCount),
+            vZ(iCount);
+
+        std::vector<int>
+            vIndex(iCount);
+
+        size_t
+            iRepeat = (size_t)(dPositions / (double)iCount) + 1;
+
+        // 40 unit radius in a 220 x 220 area, about 10% in range
+
+        for (size_t i = 0; i < iCount; ++i)
+        {
+            vX[i] = Rand.Float(-110.0f, 110.0f);
+            vY[i] = Rand.Float(-110.0f, 110.0f);
+            vZ[i] = Rand.Float(-5.0f, 5.0f);
+            vIndex[i] = (int)i;
+        }
+
+        dFast = Time(FilterByDistance, vX, vY, vZ, vIndex, iRepeat);
+        dScalar = Time(FilterByDistanceScalar, vX, vY, vZ, vIndex, iRepeat);
+
+        printf("%9zu %12.3f %12.3f %7.2fx\n", iCount, dFast, dScalar, dScalar / dFast);
+    }
+
+    return 0;
+}
+
+// ---------------------------------------------------------
@@ -0,0 +1,176 @@
+// ---------------------------------------------------------
+/*
+
+    DistanceFilterTest
+
+    Checks that FilterByDistance() returns exactly what
+    FilterByDistanceScalar() returns, in the same order:
+    for every count up to a few vector widths (so all
+    remainders are covered), unaligned inputs, positions
+    exactly on the radius and results appended to a vector
+    that isn't empty.
+
+    FilterByDistance() picks its version at compile time,
+    so this is built once per version (see CMakeLists.txt).
+    The exit code is 1 if anything differs.
+
+*/
+// ---------------------------------------------------------
+
+#include <stdio.h>
+#include <vector>
+
+#include "../DistanceFilter.h"
+#include "Bench.h"
+
+struct SPositions
+{
+    std::vector<float>
+        vX,
+        vY,
+        vZ;
+
+    std::vector<int>
+        vIndex;
+
+    void Add(float fX, float fY, float fZ)
+    {
+        vIndex.push_back((int)vX.size());
+        vX.push_back(fX);
+        vY.push_back(fY);
+        vZ.push_back(fZ);
+    }
+};
+
+// Compares both versions over iCount positions starting at iFirst.
+static void Compare(const SPositions& Positions, size_t iFirst, size_t iCount, float fX, float fY, float fZ, float fRadiusSq)
+{
+    std::vector<int>
+        vExpected,
+        vResult;
+
+    size_t
+        iExpected,
+        iResult;
+
+    iExpected = FilterByDistanceScalar(&Positions.vX[iFirst], &Positions.vY[iFirst], &Positions.vZ[iFirst], &Positions.vIndex[iFirst], iCount,
+        fX, fY, fZ, fRadiusSq, vExpected);
+
+    iResult = FilterByDistance(&Positions.vX[iFirst], &Positions.vY[iFirst], &Positions.vZ[iFirst], &Positions.vIndex[iFirst], iCount,
+        fX, fY, fZ, fRadiusSq, vResult);
+
+    CHECK(iResult == iExpected);
+    CHECK(vResult == vExpected);
+}
+
+static void TestRandom()
+{
+    static const size_t
+        s_aLargeCounts[] = { 100, 1023, 1024, 1025, 4099 };
+
+    Random
+        Rand;
+
+    SPositions
+        Positions;
+
+    for (int i = 0; i < 4200; ++i)
+        Positions.Add(Rand.Float(-20.0f, 20.0f), Rand.Float(-20.0f, 20.0f), Rand.Float(-20.0f, 20.0f));
+
+    // Every count up to 4 AVX2 widths, starting at every offset within a vector
+
+    for (size_t iFirst = 0; iFirst < 8; ++iFirst)
+        for (size_t iCount = 0; iCount <= 33; ++iCount)
+            Compare(Positions, iFirst, iCount, Rand.Float(-5.0f, 5.0f), Rand.Float(-5.0f, 5.0f), Rand.Float(-5.0f, 5.0f), 100.0f);
+
+    for (size_t iCount : s_aLargeCounts)
+        Compare(Positions, 0, iCount, 1.0f, 2.0f, 3.0f, 150.0f);
+
+    // Nothing and everything in range
+
+    Compare(Positions, 0, 1000, 0.0f, 0.0f, 0.0f, 0.0f);
+    Compare(Positions, 0, 1000, 0.0f, 0.0f, 0.0f, 10000.0f);
+}
+
+static void TestOnRadius()
+{
+    SPositions
+        Positions;
+
+    std::vector<int>
+        vResult;
+
+    size_t
+        iExpected = 0;
+
+    // 3² + 4² + 12² = 13², all exact in float. The distance is counted as inside if it's equal to the radius.
+
+    for (int i = 0; i < 37; ++i)
+    {
+        switch (i % 3)
+        {
+        case 0:
+            Positions.Add(1.0f + 3.0f, 2.0f - 4.0f, 3.0f + 12.0f); // On the radius
+            ++iExpected;
+            break;
+
+        case 1:
+            Positions.Add(1.0f - 3.0f, 2.0f + 4.0f, 3.0f - 12.5f); // Just outside
+            break;
+
+        default:
+            Positions.Add(1.0f, 2.0f, 3.0f); // Center
+            ++iExpected;
+            break;
+        }
+    }
+
+    for (size_t iCount = 0; iCount <= Positions.vX.size(); ++iCount)
+        Compare(Positions, 0, iCount, 1.0f, 2.0f, 3.0f, 169.0f);
+
+    CHECK(FilterByDistance(Positions.vX.data(), Positions.vY.data(), Positions.vZ.data(), Positions.vIndex.data(), Positions.vX.size(),
+        1.0f, 2.0f, 3.0f, 169.0f, vResult) == iExpected);
+
+    CHECK(vResult.size() == iExpected);
+
+    for (int iIndex : vResult)
+        CHECK(iIndex % 3 != 1);
+}
+
+static void TestAppend()
+{
+    SPositions
+        Positions;
+
+    std::vector<int>
+        vResult = { -1, -2 };
+
+    for (int i = 0; i < 11; ++i)
+        Positions.Add((float)i, 0.0f, 0.0f);
+
+    CHECK(FilterByDistance(Positions.vX.data(), Positions.vY.data(), Positions.vZ.data(), Positions.vIndex.data(), Positions.vX.size(),
+        0.0f, 0.0f, 0.0f, 25.0f, vResult) == 6);
+
+    CHECK((vResult == std::vector<int>{ -1, -2, 0, 1, 2, 3, 4, 5 }));
+}
+
+int main()
+{
+#if defined DNC_SIMD_AVX2
+    if (!IsAVX2Supported())
+    {
+        printf("AVX2 not supported by this CPU, skipped\n");
+        return 0;
+    }
+#endif
+
+    TestRandom();
+    TestOnRadius();
+    TestAppend();
+
+    printf("FilterByDistance (%s): %s\n", GetDistanceFilterVersion(), GetFailureCount() ? "FAILED" : "passed");
+
+    return GetFailureCount() ? 1 : 0;
+}
+
+// ---------------------------------------------------------
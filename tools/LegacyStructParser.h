@@ -0,0 +1,365 @@
+#pragma once
+
+// ---------------------------------------------------------
+/*
+
+    LegacyStructParser
+
+    The StructParser from before the string view rewrite,
+    kept only as the baseline for ParserBench: a new char[]
+    per line and section, strtok and sscanf per value and a
+    linear search over the links.
+
+    Only the parts the benchmark uses are left (Link() and
+    Parse() from memory). The secure CRT calls are mapped to
+    their POSIX counterparts so it builds on Linux.
+
+*/
+// ---------------------------------------------------------
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "../StructParser.h" // LinkType::
+
+#if defined _MSC_VER
+#define LEGACY_SSCANF sscanf_s
+#define LEGACY_STRTOK strtok_s
+#else
+#define LEGACY_SSCANF sscanf
+#define LEGACY_STRTOK strtok_r
+#endif
+
+// ---------------------------------------------------------
+
+template<typename T>
+class LegacyStructParser
+{
+private:
+
+    struct StructLink
+    {
+        int     iType = -1;
+        size_t  iElementSize = 0;
+        size_t  iIndexes = 0;
+
+        size_t  iOffset = 0;
+
+        char    *pSection = nullptr;
+        char    *pKey = nullptr;
+    };
+
+    T*          m_pBase;
+
+    std::vector<StructLink*>
+                m_vLinks;
+
+    bool _CmpStr(const char* szText1, const char* szText2, bool bIgnoreCase)
+    {
+        size_t
+            iLen1 = strlen(szText1),
+            iLen2 = strlen(szText2);
+
+        if (iLen1 != iLen2)
+            return false;
+
+        if (bIgnoreCase)
+        {
+            for (size_t i = 0; i < iLen1; ++i)
+                if (tolower((int)szText1[i]) != tolower((int)szText2[i]))
+                    return false;
+        }
+        else
+        {
+            for (size_t i = 0; i < iLen1; ++i)
+                if (szText1[i] != szText2[i])
+                    return false;
+        }
+
+        return true;
+    }
+
+    size_t _RemovePadding(char* szText)
+    {
+        size_t
+            iLen = strlen(szText),
+            iLenNew,
+            iFirstChar = iLen,
+            iLastChar = iLen;
+
+        for (size_t i = 0; i < iLen; ++i)
+        {
+            if (szText[i] != ' ')
+            {
+                if (iFirstChar == iLen)
+                    iFirstChar = i;
+
+                iLastChar = i;
+            }
+        }
+
+        if (iFirstChar == iLen)
+        {
+            szText[0] = 0;
+            return 0;
+        }
+        else if (iFirstChar == iLastChar)
+        {
+            szText[0] = szText[iFirstChar];
+            szText[1] = 0;
+            return 1;
+        }
+
+        iLenNew = iLastChar - iFirstChar + 1;
+
+        memmove(szText, szText + iFirstChar, iLenNew);
+        szText[iLenNew] = 0;
+
+        return iLenNew;
+    }
+
+public:
+
+    LegacyStructParser(T* pBase = nullptr) :
+        m_pBase(pBase)
+    {
+
+    }
+
+    ~LegacyStructParser()
+    {
+        for (auto &p : m_vLinks)
+        {
+            delete[] p->pSection;
+            delete[] p->pKey;
+            delete p;
+        }
+    }
+
+    bool Link(int iType, void* pTarget, size_t iElementSize, size_t iIndexes, const char* szSection, const char* szKey)
+    {
+        StructLink
+            *pLink;
+
+        size_t
+            iLen,
+            iOffset;
+
+        if (iType < 0 || iType >= LinkType::MAX || !m_pBase || (size_t)(void*)pTarget < (size_t)(void*)m_pBase)
+            return false;
+
+        iOffset = (size_t)(void*)pTarget - (size_t)(void*)m_pBase;
+
+        if (iOffset + iElementSize * (iIndexes == 0 ? 1 : iIndexes) >= sizeof(T))
+            return false;
+
+        pLink = new StructLink;
+
+        pLink->iType = iType;
+        pLink->iElementSize = iElementSize;
+        pLink->iIndexes = iIndexes;
+
+        pLink->iOffset = iOffset;
+
+        iLen = strlen(szSection) + 1;
+        pLink->pSection = new char[iLen];
+        memcpy(pLink->pSection, szSection, iLen);
+
+        iLen = strlen(szKey) + 1;
+        pLink->pKey = new char[iLen];
+        memcpy(pLink->pKey, szKey, iLen);
+
+        m_vLinks.push_back(pLink);
+
+        return true;
+    }
+
+    int Parse(const char* pSource, T* pTarget, bool bIgnoreCase = true, size_t iSourceLen = 0)
+    {
+        char
+            *pLine = nullptr,
+            *pSection = nullptr;
+
+        int
+            iParsedValues = 0;
+
+        size_t
+            iLen = (iSourceLen == 0 ? strlen(pSource) : iSourceLen),
+            iLineStart = 0,
+            iLineLen = 0,
+            iTmpLen;
+
+        if (!iLen)
+            return -1;
+
+        for (size_t i = 0; i <= iLen; ++i)
+        {
+            if (i == iLen || pSource[i] == '\r' || pSource[i] == '\n' || pSource[i] == 0)
+            {
+                if (iLineLen < 2)
+                {
+                    iLineStart = i + 1;
+                    iLineLen = 0;
+                    continue;
+                }
+
+                if (pLine)
+                {
+                    delete[] pLine;
+                    pLine = nullptr;
+                }
+
+                pLine = new char[iLineLen + 1];
+                memcpy(pLine, pSource + iLineStart, iLineLen);
+                pLine[iLineLen] = 0;
+
+                iLineStart = i + 1;
+                iLineLen = 0;
+
+                iTmpLen = _RemovePadding(pLine);
+
+                if (iTmpLen < 2)
+                    continue;
+
+                if (pLine[0] == '[' && pLine[iTmpLen - 1] == ']')
+                {
+                    pLine[0] = ' ';
+                    pLine[iTmpLen - 1] = ' ';
+
+                    if (pSection)
+                        delete[] pSection;
+
+                    if (_RemovePadding(pLine))
+                    {
+                        pSection = pLine;
+                        pLine = nullptr;
+                    }
+                    else
+                    {
+                        pSection = nullptr;
+                    }
+                }
+                else
+                {
+                    if (ParseValue(pSection, pLine, pTarget, bIgnoreCase))
+                        ++iParsedValues;
+                }
+            }
+            else
+            {
+                ++iLineLen;
+            }
+        }
+
+        if (pSection)
+            delete[] pSection;
+
+        if (pLine)
+            delete[] pLine;
+
+        return iParsedValues;
+    }
+
+    bool ParseValue(char* pSection, char* pLine, T* pTarget, bool bIgnoreCase)
+    {
+        char
+            *pKey,
+            *pValue,
+            *pContext;
+
+        size_t
+            iSize,
+            iPointer;
+
+        pKey = LEGACY_STRTOK(pLine, "=", &pContext);
+
+        if (!pKey || !_RemovePadding(pKey))
+            return false;
+
+        pValue = LEGACY_STRTOK(nullptr, "=", &pContext);
+
+        if (!pValue || !_RemovePadding(pValue))
+            return false;
+
+        if (_CmpStr(pValue, "true", true))
+        {
+            pValue[0] = '1';
+            pValue[1] = 0;
+        }
+        else if (_CmpStr(pValue, "false", true))
+        {
+            pValue[0] = '0';
+            pValue[1] = 0;
+        }
+
+        for (auto &pLink : m_vLinks)
+        {
+            if (((!pSection && !pLink->pSection) || (pSection && _CmpStr(pSection, pLink->pSection, bIgnoreCase))) &&
+                _CmpStr(pKey, pLink->pKey, bIgnoreCase)
+                )
+            {
+                iPointer = (size_t)pTarget + pLink->iOffset;
+
+                switch (pLink->iType)
+                {
+                case LinkType::SIGNED:
+
+                    if (pLink->iElementSize == 1)
+                        LEGACY_SSCANF(pValue, "%hhi", (signed char*)iPointer);
+                    else if (pLink->iElementSize == 2)
+                        LEGACY_SSCANF(pValue, "%hi", (short*)iPointer);
+                    else if (pLink->iElementSize == 4)
+                        LEGACY_SSCANF(pValue, "%i", (int*)iPointer);
+                    else if (pLink->iElementSize == 8)
+                        LEGACY_SSCANF(pValue, "%lli", (long long*)iPointer);
+
+                    break;
+
+                case LinkType::UNSIGNED:
+
+                    if (pLink->iElementSize == 1)
+                        LEGACY_SSCANF(pValue, "%hhu", (unsigned char*)iPointer);
+                    else if (pLink->iElementSize == 2)
+                        LEGACY_SSCANF(pValue, "%hu", (unsigned short*)iPointer);
+                    else if (pLink->iElementSize == 4)
+                        LEGACY_SSCANF(pValue, "%u", (unsigned int*)iPointer);
+                    else if (pLink->iElementSize == 8)
+                        LEGACY_SSCANF(pValue, "%llu", (unsigned long long*)iPointer);
+
+                    break;
+
+                case LinkType::FLOAT:
+
+                    if (pLink->iElementSize == 4)
+                        LEGACY_SSCANF(pValue, "%f", (float*)iPointer);
+                    else if (pLink->iElementSize == 8)
+                        LEGACY_SSCANF(pValue, "%lf", (double*)iPointer);
+
+                    break;
+
+                case LinkType::STRING:
+
+                    iSize = pLink->iIndexes == 0 ? strlen(pValue) + 1 : pLink->iIndexes;
+
+                    if (pLink->iElementSize == 1 && iSize > 0)
+                    {
+                        iSize = strcspn(pValue, "\t\n") < iSize ? strcspn(pValue, "\t\n") : iSize - 1;
+                        memcpy((char*)iPointer, pValue, iSize);
+                        ((char*)iPointer)[iSize] = 0;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        return true;
+    }
+};
+
+#undef LEGACY_SSCANF
+#undef LEGACY_STRTOK
+
+// ---------------------------------------------------------
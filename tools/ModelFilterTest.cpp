@@ -0,0 +1,246 @@
+// ---------------------------------------------------------
+/*
+
+    ModelFilterTest
+
+    Checks ModelFilter against a plain std::set version of
+    the rules in ModelFilter.h, over thousands of generated
+    allow/block lists of up to a few thousand entries: with
+    and without an allow list, duplicates, models on both
+    lists, 0, negative entries and models from MODEL_COUNT
+    on. The same filter is rebuilt for every list, so a
+    Build() that leaves anything from the previous lists
+    behind is caught too.
+
+    The exit code is 1 if anything differs.
+
+*/
+// ---------------------------------------------------------
+
+#include <limits.h>
+#include <stdio.h>
+#include <set>
+#include <vector>
+
+#include "../ModelFilter.h"
+#include "Bench.h"
+
+constexpr int MODEL_COUNT = (int)ModelFilter::MODEL_COUNT;
+
+// The rules from ModelFilter.h, written the slow and obvious way
+
+class ReferenceFilter
+{
+private:
+
+    std::set<int>
+        m_Allowed,
+        m_Blocked;
+
+    bool
+        m_bAllowList = false;
+
+public:
+
+    ReferenceFilter(const std::vector<int>& vAllowed, const std::vector<int>& vBlocked)
+    {
+        for (int iModel : vAllowed)
+        {
+            if (iModel > 0)
+            {
+                m_Allowed.insert(iModel);
+                m_bAllowList = true;
+            }
+        }
+
+        for (int iModel : vBlocked)
+            if (iModel > 0)
+                m_Blocked.insert(iModel);
+    }
+
+    bool IsAllowed(int iModel) const
+    {
+        if (iModel < 0 || iModel >= MODEL_COUNT)
+            return !m_bAllowList;
+
+        if (m_Blocked.count(iModel))
+            return false;
+
+        return !m_bAllowList || m_Allowed.count(iModel) != 0;
+    }
+};
+
+// Mostly real looking model IDs, some invalid ones and some repeats.
+static int GenerateModel(Random& Rand, const std::vector<int>& vSoFar)
+{
+    switch (Rand.Int(0, 19))
+    {
+    case 0:
+        return Rand.Int(-100, 0);
+
+    case 1:
+        return Rand.Int(MODEL_COUNT - 2, MODEL_COUNT + 100);
+
+    case 2:
+        return Rand.Int(0, 1) ? INT_MAX : INT_MIN;
+
+    case 3:
+    case 4:
+        if (!vSoFar.empty())
+            return vSoFar[(size_t)Rand.Int(0, (int)vSoFar.size() - 1)];
+
+        return Rand.Int(1, 255);
+
+    case 5:
+        return Rand.Int(1, 255); // Few values, so allow and block lists overlap
+
+    default:
+        return Rand.Int(1, 20000);
+    }
+}
+
+static std::vector<int> GenerateList(Random& Rand, int iMaxSize, const std::vector<int>& vOther)
+{
+    std::vector<int>
+        vList;
+
+    int
+        iSize = Rand.Int(0, iMaxSize);
+
+    for (int i = 0; i < iSize; ++i)
+    {
+        // Sometimes take an entry of the other list, so a model is allowed and blocked
+
+        if (!vOther.empty() && Rand.Int(0, 9) == 0)
+            vList.push_back(vOther[(size_t)Rand.Int(0, (int)vOther.size() - 1)]);
+        else
+            vList.push_back(GenerateModel(Rand, vList));
+    }
+
+    return vList;
+}
+
+// Returns the number of models IsAllowed() got wrong.
+static int Compare(const ModelFilter& Filter, const ReferenceFilter& Reference, const std::vector<int>& vModels)
+{
+    int
+        iWrong = 0;
+
+    for (int iModel : vModels)
+        if (Filter.IsAllowed(iModel) != Reference.IsAllowed(iModel))
+            ++iWrong;
+
+    return iWrong;
+}
+
+static std::vector<int> GetAllModels()
+{
+    std::vector<int>
+        vModels = { INT_MIN, -100, -1, MODEL_COUNT + 1, MODEL_COUNT + 100, INT_MAX };
+
+    for (int i = 0; i <= MODEL_COUNT; ++i)
+        vModels.push_back(i);
+
+    return vModels;
+}
+
+static void TestDefault()
+{
+    ModelFilter
+        Filter;
+
+    ReferenceFilter
+        Reference({}, {});
+
+    CHECK(Compare(Filter, Reference, GetAllModels()) == 0);
+}
+
+static void TestRandom()
+{
+    constexpr int
+        LIST_COUNT = 3000,
+        FULL_CHECK_INTERVAL = 100; // Every x lists all models are checked, otherwise the listed ones and a sample
+
+    Random
+        Rand;
+
+    ModelFilter
+        Filter;
+
+    std::vector<int>
+        vAll = GetAllModels(),
+        vAllowed,
+        vBlocked,
+        vModels;
+
+    for (int iList = 0; iList < LIST_COUNT; ++iList)
+    {
+        // About a third without an allow list, some lists with thousands of entries
+
+        vAllowed = Rand.Int(0, 2) == 0 ? std::vector<int>() : GenerateList(Rand, Rand.Int(0, 9) == 0 ? 4000 : 200, {});
+        vBlocked = GenerateList(Rand, Rand.Int(0, 9) == 0 ? 4000 : 200, vAllowed);
+
+        Filter.Build(vAllowed.data(), vAllowed.size(), vBlocked.data(), vBlocked.size());
+
+        ReferenceFilter
+            Reference(vAllowed, vBlocked);
+
+        if (iList % FULL_CHECK_INTERVAL == 0)
+        {
+            CHECK(Compare(Filter, Reference, vAll) == 0);
+            continue;
+        }
+
+        vModels = vAllowed;
+        vModels.insert(vModels.end(), vBlocked.begin(), vBlocked.end());
+
+        for (int i = 0; i < 1000; ++i)
+            vModels.push_back(Rand.Int(-10, MODEL_COUNT + 10));
+
+        CHECK(Compare(Filter, Reference, vModels) == 0);
+    }
+}
+
+// Every model listed: all allowed, every third blocked.
+static void TestFull()
+{
+    ModelFilter
+        Filter;
+
+    std::vector<int>
+        vAllowed,
+        vBlocked;
+
+    for (int i = 1; i < MODEL_COUNT; ++i)
+    {
+        vAllowed.push_back(i);
+
+        if (i % 3 == 0)
+            vBlocked.push_back(i);
+    }
+
+    Filter.Build(vAllowed.data(), vAllowed.size(), vBlocked.data(), vBlocked.size());
+
+    CHECK(Compare(Filter, ReferenceFilter(vAllowed, vBlocked), GetAllModels()) == 0);
+
+    // Only models outside the bitset on the allow list still make it an allow list
+
+    vAllowed = { 0, -5, MODEL_COUNT, MODEL_COUNT + 1 };
+    Filter.Build(vAllowed.data(), vAllowed.size(), nullptr, 0);
+
+    CHECK(Compare(Filter, ReferenceFilter(vAllowed, {}), GetAllModels()) == 0);
+    CHECK(!Filter.IsAllowed(MODEL_COUNT));
+}
+
+int main()
+{
+    TestDefault();
+    TestRandom();
+    TestFull();
+
+    printf("ModelFilter: %s\n", GetFailureCount() ? "FAILED" : "passed");
+
+    return GetFailureCount() ? 1 : 0;
+}
+
+// ---------------------------------------------------------
@@ -0,0 +1,483 @@
+// ---------------------------------------------------------
+/*
+
+    ParserBench
+
+    Parse throughput of StructParser compared to the parser
+    it replaced (see LegacyStructParser.h), in MB/s and heap
+    allocations per parse.
+
+    - config: A full DoNotCrash config with comments, parsed
+      over and over like the plugin does on every load.
+    - numbers: A large table of signed, unsigned and float
+      values of all sizes, 96 keys per section. Both parsers
+      have to decode the same values, otherwise it fails.
+    - threads: ParseParallel() on 20000 per-model sections
+      (about 1.5 MB) with 1 to N threads. The result has to
+      be the same as with Parse(), otherwise it fails.
+    - skewed: The same, but the first section is half of
+      the source, so the split points bunch up behind it.
+
+    Usage: ParserBench [megabytes per test] [max threads]
+    (default 64 MB, one thread per hardware thread)
+
+    The exit code is 1 if the parsers disagree.
+
+*/
+// ---------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+#include "../StructParser.h"
+#include "../Config.h"
+#include "LegacyStructParser.h"
+#include "AllocCounter.h"
+#include "Bench.h"
+
+// Both parsers have the same Link(), see the old LoadConfig().
+template<typename P>
+static void LinkConfig(P& Parser, SConfig& Base)
+{
+#define VAR(x) &x, sizeof(x)
+
+    Parser.Link(LinkType::BOOL, VAR(Base.bActive), 1, "General", "Active");
+    Parser.Link(LinkType::BOOL, VAR(Base.bActiveOnMission), 1, "General", "ActiveOnMission");
+    Parser.Link(LinkType::BOOL, VAR(Base.bActiveOnSubmission), 1, "General", "ActiveOnSubmission");
+    Parser.Link(LinkType::UNSIGNED, VAR(Base.iSwapDelay), 1, "General", "SwapDelay");
+    Parser.Link(LinkType::UNSIGNED, VAR(Base.iSwapBackDelay), 1, "General", "SwapBackDelay");
+    Parser.Link(LinkType::BOOL, VAR(Base.bHotReload), 1, "General", "HotReload");
+    Parser.Link(LinkType::UNSIGNED, VAR(Base.iHotReloadInterval), 1, "General", "HotReloadInterval");
+    Parser.Link(LinkType::BOOL, VAR(Base.bPredictiveSwap), 1, "General", "PredictiveSwap");
+    Parser.Link(LinkType::FLOAT, VAR(Base.fPredictRadiusScale), 1, "General", "PredictRadiusScale");
+    Parser.Link(LinkType::SIGNED, VAR(Base.iTargetPolicy), 1, "General", "TargetPolicy");
+    Parser.Link(LinkType::BOOL, VAR(Base.bSwapToMissionVehicles), 1, "Filter", "MissionVehicles");
+    Parser.Link(LinkType::BOOL, VAR(Base.bPedToPed), 1, "SwapTypes", "PedToPed");
+    Parser.Link(LinkType::BOOL, VAR(Base.bPedToVehicle), 1, "SwapTypes", "PedToVehicle");
+    Parser.Link(LinkType::BOOL, VAR(Base.bPedToObject), 1, "SwapTypes", "PedToObject");
+    Parser.Link(LinkType::BOOL, VAR(Base.bVehicleToPed), 1, "SwapTypes", "VehicleToPed");
+    Parser.Link(LinkType::BOOL, VAR(Base.bVehicleToVehicle), 1, "SwapTypes", "VehicleToVehicle");
+    Parser.Link(LinkType::BOOL, VAR(Base.bVehicleToObject), 1, "SwapTypes", "VehicleToObject");
+    Parser.Link(LinkType::BOOL, VAR(Base.bObjectToPed), 1, "SwapTypes", "ObjectToPed");
+    Parser.Link(LinkType::BOOL, VAR(Base.bObjectToVehicle), 1, "SwapTypes", "ObjectToVehicle");
+    Parser.Link(LinkType::BOOL, VAR(Base.bObjectToObject), 1, "SwapTypes", "ObjectToObject");
+    Parser.Link(LinkType::UNSIGNED, VAR(Base.iMaxPhysicsVehicles), 1, "Physics", "MaxVehicles");
+    Parser.Link(LinkType::FLOAT, VAR(Base.fPhysicsRadius), 1, "Physics", "Radius");
+    Parser.Link(LinkType::FLOAT, VAR(Base.fPhysicsDemoteRadius), 1, "Physics", "DemoteRadius");
+
+#undef VAR
+}
+
+static const char* const g_szConfigSource =
+    "; DoNotCrash config\r\n"
+    "\r\n"
+    "[General]\r\n"
+    "; Set to false to disable the plugin\r\n"
+    "Active = true\r\n"
+    "ActiveOnMission = false\r\n"
+    "ActiveOnSubmission = false\r\n"
+    "\r\n"
+    "; Milliseconds between swaps and before swapping back into the previous vehicle\r\n"
+    "SwapDelay = 100\r\n"
+    "SwapBackDelay = 1500\r\n"
+    "\r\n"
+    "HotReload = false\r\n"
+    "HotReloadInterval = 1000\r\n"
+    "PredictiveSwap = false\r\n"
+    "PredictRadiusScale = 0.75\r\n"
+    "TargetPolicy = 0\r\n"
+    "\r\n"
+    "[Filter]\r\n"
+    "MissionVehicles = false\r\n"
+    "\r\n"
+    "[SwapTypes]\r\n"
+    "PedToPed = false\r\n"
+    "PedToVehicle = false\r\n"
+    "PedToObject = false\r\n"
+    "VehicleToPed = false\r\n"
+    "VehicleToVehicle = true\r\n"
+    "VehicleToObject = false\r\n"
+    "ObjectToPed = false\r\n"
+    "ObjectToVehicle = false\r\n"
+    "ObjectToObject = false\r\n"
+    "\r\n"
+    "[Physics]\r\n"
+    "MaxVehicles = 32\r\n"
+    "Radius = 40.0\r\n"
+    "DemoteRadius = 60.0\r\n";
+
+static constexpr int
+    NUMERIC_COLUMNS = 16; // Per type
+
+struct SNumericTable
+{
+    int         aSigned[NUMERIC_COLUMNS];
+    unsigned int
+                aUnsigned[NUMERIC_COLUMNS];
+    short       aShort[NUMERIC_COLUMNS];
+    long long   aLong[NUMERIC_COLUMNS];
+    float       aFloat[NUMERIC_COLUMNS];
+    double      aDouble[NUMERIC_COLUMNS];
+
+    int         iUnused; // The old Link() refuses the last member of a struct
+};
+
+// One key per element, "S0" = aSigned[0] and so on. The keys are linked one by one, not as lists, so the old parser can
+// read them too.
+template<typename P>
+static void LinkNumericTable(P& Parser, SNumericTable& Base)
+{
+    char
+        szKey[8];
+
+    for (int i = 0; i < NUMERIC_COLUMNS; ++i)
+    {
+        snprintf(szKey, sizeof(szKey), "S%d", i);
+        Parser.Link(LinkType::SIGNED, &Base.aSigned[i], sizeof(int), 1, "Table", szKey);
+
+        snprintf(szKey, sizeof(szKey), "U%d", i);
+        Parser.Link(LinkType::UNSIGNED, &Base.aUnsigned[i], sizeof(unsigned int), 1, "Table", szKey);
+
+        snprintf(szKey, sizeof(szKey), "H%d", i);
+        Parser.Link(LinkType::SIGNED, &Base.aShort[i], sizeof(short), 1, "Table", szKey);
+
+        snprintf(szKey, sizeof(szKey), "L%d", i);
+        Parser.Link(LinkType::SIGNED, &Base.aLong[i], sizeof(long long), 1, "Table", szKey);
+
+        snprintf(szKey, sizeof(szKey), "F%d", i);
+        Parser.Link(LinkType::FLOAT, &Base.aFloat[i], sizeof(float), 1, "Table", szKey);
+
+        snprintf(szKey, sizeof(szKey), "D%d", i);
+        Parser.Link(LinkType::FLOAT, &Base.aDouble[i], sizeof(double), 1, "Table", szKey);
+    }
+}
+
+// iRows copies of the table with random values, about 2.5 KB each.
+static std::string MakeNumericTable(int iRows)
+{
+    Random
+        Rand;
+
+    std::string
+        Source;
+
+    char
+        szLine[64];
+
+    for (int iRow = 0; iRow < iRows; ++iRow)
+    {
+        Source += "[Table]\n";
+
+        for (int i = 0; i < NUMERIC_COLUMNS; ++i)
+        {
+            snprintf(szLine, sizeof(szLine), "S%d = %d\n", i, (int)Rand.Next());
+            Source += szLine;
+            snprintf(szLine, sizeof(szLine), "U%d = %u\n", i, Rand.Next());
+            Source += szLine;
+            snprintf(szLine, sizeof(szLine), "H%d = %d\n", i, Rand.Int(-32768, 32767));
+            Source += szLine;
+            snprintf(szLine, sizeof(szLine), "L%d = %lld\n", i, (long long)Rand.Next() * (long long)Rand.Int(-100000, 100000));
+            Source += szLine;
+            snprintf(szLine, sizeof(szLine), "F%d = %.6g\n", i, Rand.Float(-10000.0f, 10000.0f));
+            Source += szLine;
+            snprintf(szLine, sizeof(szLine), "D%d = %.15g\n", i, (double)Rand.Float(-1.0f, 1.0f) / 3.0);
+            Source += szLine;
+        }
+    }
+
+    return Source;
+}
+
+static constexpr int
+    MODEL_COUNT = 20000;
+
+struct SModelTable
+{
+    float       aMass[MODEL_COUNT];
+    int         aFlags[MODEL_COUNT];
+    unsigned char
+                aColors[MODEL_COUNT];
+
+    int         iUnused;
+};
+
+// [Model<i>] with Mass, Flags and Color for every model.
+template<typename P>
+static void LinkModelTable(P& Parser, SModelTable& Base)
+{
+    char
+        szSection[16];
+
+    for (int i = 0; i < MODEL_COUNT; ++i)
+    {
+        snprintf(szSection, sizeof(szSection), "Model%d", i);
+
+        Parser.Link(LinkType::FLOAT, &Base.aMass[i], sizeof(float), 1, szSection, "Mass");
+        Parser.Link(LinkType::SIGNED, &Base.aFlags[i], sizeof(int), 1, szSection, "Flags");
+        Parser.Link(LinkType::UNSIGNED, &Base.aColors[i], sizeof(unsigned char), 1, szSection, "Color");
+    }
+}
+
+static std::string MakeModelTable()
+{
+    Random
+        Rand;
+
+    std::string
+        Source;
+
+    char
+        szSection[128];
+
+    for (int i = 0; i < MODEL_COUNT; ++i)
+    {
+        snprintf(szSection, sizeof(szSection), "[Model%d]\r\n; Generated\r\nMass = %.1f\r\nFlags = %d\r\nColor = %d\r\n\r\n",
+            i, Rand.Float(500.0f, 5000.0f), Rand.Int(0, 0x7FFFFFFF), Rand.Int(0, 255));
+
+        Source += szSection;
+    }
+
+    return Source;
+}
+
+// ---------------------------------------------------------
+
+struct SResult
+{
+    double      dMBPerSecond;
+    double      dAllocations; // Per parse
+};
+
+// Parses Source into a fresh T until about dMegabytes were parsed.
+template<typename P, typename T>
+static SResult Run(P& Parser, const std::string& Source, double dMegabytes)
+{
+    SResult
+        Result;
+
+    Stopwatch
+        Timer;
+
+    size_t
+        iAllocations,
+        iRepeat = (size_t)(dMegabytes * 1024.0 * 1024.0 / (double)Source.size()) + 1;
+
+    int
+        iParsed = 0;
+
+    T
+        Target;
+
+    iAllocations = GetAllocationCount();
+    Timer.Restart();
+
+    for (size_t i = 0; i < iRepeat; ++i)
+        iParsed += Parser.Parse(Source.c_str(), &Target, true, Source.size());
+
+    Result.dMBPerSecond = (double)Source.size() * (double)iRepeat / (1024.0 * 1024.0) / (Timer.GetMicroseconds() / 1000000.0);
+    Result.dAllocations = (double)(GetAllocationCount() - iAllocations) / (double)iRepeat;
+
+    KeepResult(iParsed);
+
+    return Result;
+}
+
+static void PrintResult(const char* szTest, const char* szParser, const SResult& Result, const SResult* pBaseline)
+{
+    printf("%-8s %-10s %10.1f %12.1f", szTest, szParser, Result.dMBPerSecond, Result.dAllocations);
+
+    if (pBaseline)
+        printf(" %8.1fx", Result.dMBPerSecond / pBaseline->dMBPerSecond);
+
+    printf("\n");
+}
+
+static void BenchConfig(double dMegabytes)
+{
+    SConfig
+        Base;
+
+    StructParser<SConfig>
+        Parser(&Base);
+
+    LegacyStructParser<SConfig>
+        Legacy(&Base);
+
+    std::string
+        Source = g_szConfigSource;
+
+    SResult
+        LegacyResult,
+        Result;
+
+    LinkConfig(Parser, Base);
+    LinkConfig(Legacy, Base);
+
+    LegacyResult = Run<LegacyStructParser<SConfig>, SConfig>(Legacy, Source, dMegabytes);
+    Result = Run<StructParser<SConfig>, SConfig>(Parser, Source, dMegabytes);
+
+    PrintResult("config", "legacy", LegacyResult, nullptr);
+    PrintResult("config", "current", Result, &LegacyResult);
+}
+
+// Returns false if the parsers decoded different values.
+static bool BenchNumbers(double dMegabytes)
+{
+    SNumericTable
+        Base,
+        LegacyTarget = {},
+        Target = {};
+
+    StructParser<SNumericTable>
+        Parser(&Base);
+
+    LegacyStructParser<SNumericTable>
+        Legacy(&Base);
+
+    std::string
+        Source = MakeNumericTable(400);
+
+    size_t
+        iRow = Source.find("[Table]", Source.size() / 2);
+
+    SResult
+        LegacyResult,
+        Result;
+
+    LinkNumericTable(Parser, Base);
+    LinkNumericTable(Legacy, Base);
+
+    // Later rows override earlier ones, so only one row is compared
+
+    Legacy.Parse(Source.c_str() + iRow, &LegacyTarget, true, Source.size() - iRow);
+    Parser.Parse(Source.c_str() + iRow, &Target, true, Source.size() - iRow);
+
+    if (memcmp(&LegacyTarget, &Target, sizeof(Target)) != 0 || Parser.GetErrorCount())
+    {
+        printf("numbers: the parsers decoded different values\n");
+        return false;
+    }
+
+    LegacyResult = Run<LegacyStructParser<SNumericTable>, SNumericTable>(Legacy, Source, dMegabytes);
+    Result = Run<StructParser<SNumericTable>, SNumericTable>(Parser, Source, dMegabytes);
+
+    PrintResult("numbers", "legacy", LegacyResult, nullptr);
+    PrintResult("numbers", "current", Result, &LegacyResult);
+
+    return true;
+}
+
+// Times ParseParallel() on Source with 1 to iMaxThreads threads.
+// Returns false if a parallel parse doesn't match Parse().
+static bool RunThreads(const char* szTest, StructParser<SModelTable>& Parser, const std::string& Source, double dMegabytes, size_t iMaxThreads)
+{
+    static SModelTable
+        s_Expected,
+        s_Target;
+
+    size_t
+        iRepeat = (size_t)(dMegabytes * 1024.0 * 1024.0 / (double)Source.size()) + 1;
+
+    Stopwatch
+        Timer;
+
+    double
+        dMBPerSecond,
+        dSingle = 0.0;
+
+    memset(&s_Expected, 0, sizeof(s_Expected));
+    Parser.Parse(Source.c_str(), &s_Expected, true, Source.size());
+
+    for (size_t iThreads = 1; iThreads <= iMaxThreads; iThreads = iThreads < iMaxThreads ? std::min(iThreads * 2, iMaxThreads) : iThreads + 1)
+    {
+        memset(&s_Target, 0, sizeof(s_Target));
+
+        Parser.ParseParallel(Source.c_str(), &s_Target, iThreads, true, Source.size());
+
+        if (memcmp(&s_Target, &s_Expected, sizeof(s_Target)) != 0)
+        {
+            printf("%s: %zu threads decoded different values than Parse()\n", szTest, iThreads);
+            return false;
+        }
+
+        Timer.Restart();
+
+        for (size_t i = 0; i < iRepeat; ++i)
+            Parser.ParseParallel(Source.c_str(), &s_Target, iThreads, true, Source.size());
+
+        dMBPerSecond = (double)Source.size() * (double)iRepeat / (1024.0 * 1024.0) / (Timer.GetMicroseconds() / 1000000.0);
+
+        if (iThreads == 1)
+            dSingle = dMBPerSecond;
+
+        printf("%-8s %-10zu %10.1f %8.1fx\n", szTest, iThreads, dMBPerSecond, dMBPerSecond / dSingle);
+    }
+
+    return true;
+}
+
+// Returns false if a parallel parse doesn't match Parse().
+static bool BenchThreads(double dMegabytes, size_t iMaxThreads)
+{
+    static SModelTable
+        s_Base;
+
+    StructParser<SModelTable>
+        Parser(&s_Base);
+
+    std::string
+        Source = MakeModelTable(),
+        Skewed;
+
+    LinkModelTable(Parser, s_Base);
+
+    printf("\n%-8s %-10s %10s %9s\n", "test", "threads", "MB/s", "speedup");
+
+    if (!RunThreads("threads", Parser, Source, dMegabytes, iMaxThreads))
+        return false;
+
+    // The first section takes up half of the source, so most split points land behind it on headers only a few bytes
+    // apart. Extra threads must not make this slower than one.
+
+    Skewed = Source.substr(0, Source.find("[Model1]"));
+
+    while (Skewed.size() < Source.size())
+        Skewed += "; Padding, the same size as the rest of the source so the first section is half of it\r\n";
+
+    Skewed += Source.substr(Source.find("[Model1]"));
+
+    return RunThreads("skewed", Parser, Skewed, dMegabytes, iMaxThreads);
+}
+
+int main(int argc, char* argv[])
+{
+    double
+        dMegabytes = argc > 1 ? atof(argv[1]) : 64.0;
+
+    size_t
+        iMaxThreads = argc > 2 ? (size_t)atoi(argv[2]) : (size_t)std::thread::hardware_concurrency();
+
+    if (dMegabytes <= 0.0)
+        dMegabytes = 1.0;
+
+    if (iMaxThreads == 0)
+        iMaxThreads = 1;
+
+    printf("%.1f MB per test, %u hardware threads\n\n", dMegabytes, std::thread::hardware_concurrency());
+    printf("%-8s %-10s %10s %12s %9s\n", "test", "parser", "MB/s", "allocs/parse", "speedup");
+
+    BenchConfig(dMegabytes);
+
+    if (!BenchNumbers(dMegabytes))
+        return 1;
+
+    if (!BenchThreads(dMegabytes, iMaxThreads))
+        return 1;
+
+    return 0;
+}
+
+// ---------------------------------------------------------
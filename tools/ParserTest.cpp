@@ -0,0 +1,626 @@
+// ---------------------------------------------------------
+/*
+
+    ParserTest
+
+    Tests for StructParser:
+    - Parsing from memory allocates nothing per line, no
+      matter how long the source is, and doesn't modify it.
+    - Padding, line endings, sections and bad lines.
+    - Lists: a shorter list from a later source replaces a
+      longer one, parsed into a struct or into a document.
+    - Update(): changed values are replaced in place with
+      comments, padding and line endings kept, missing keys
+      and sections are added, lists and floats read back as
+      the same value, and a file that is up to date is not
+      written at all. Uses files in the working directory.
+    - StructStream: the same source fed in chunks of random
+      sizes, single bytes and split inside every CRLF and
+      section header gives the same result as Parse(). Lines
+      longer than LINE_SIZE are LENGTH errors.
+
+    The exit code is 1 if a check fails.
+
+*/
+// ---------------------------------------------------------
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../StructParser.h"
+#include "AllocCounter.h"
+#include "Bench.h"
+
+struct STestConfig
+{
+    bool        bActive = false;
+    int         iDelay = 0;
+    unsigned int
+                iCount = 0;
+    short       iSmall = 0;
+    float       fRadius = 0.0f;
+    double      dScale = 0.0;
+    char        szName[16] = {};
+    int         aList[3] = { 7, 7, 7 };
+};
+
+static constexpr auto g_TestSchema = MakeStructSchema<STestConfig>({
+    STRUCT_FIELD(STestConfig, bActive, "General", "Active"),
+    STRUCT_FIELD(STestConfig, iDelay, "General", "Delay"),
+    STRUCT_FIELD(STestConfig, iCount, "General", "Count"),
+    STRUCT_FIELD(STestConfig, iSmall, "Other", "Small"),
+    STRUCT_FIELD(STestConfig, fRadius, "Other", "Radius"),
+    STRUCT_FIELD(STestConfig, dScale, "Other", "Scale"),
+    STRUCT_FIELD(STestConfig, szName, "Other", "Name"),
+    STRUCT_FIELD(STestConfig, aList, "Other", "List")
+});
+
+// iBlocks copies of a small config with the values of the last block depending on iBlocks.
+static std::string MakeSource(int iBlocks)
+{
+    std::string
+        Source;
+
+    char
+        szBlock[512];
+
+    for (int i = 1; i <= iBlocks; ++i)
+    {
+        snprintf(szBlock, sizeof(szBlock),
+            "; Block %d\r\n"
+            "[General]\r\n"
+            "  Active = %s  \r\n"
+            "Delay=%d\n"
+            "Count = %u\n"
+            "Unknown = 5\n"
+            "\n"
+            "[ Other ]\n"
+            "Small = %d\n"
+            "Radius = %d.5\n"
+            "Scale = 0.25\n"
+            "Name = Block%d\n"
+            "not a key value pair\n",
+            i, i % 2 ? "true" : "false", -i, (unsigned int)i * 3, i % 1000, i, i);
+
+        Source += szBlock;
+    }
+
+    return Source;
+}
+
+static void TestNoAllocations()
+{
+    static const int
+        s_aBlocks[] = { 1, 10, 10000 };
+
+    StructParser<STestConfig>
+        Parser(g_TestSchema);
+
+    STestConfig
+        Config;
+
+    size_t
+        iAllocations;
+
+    for (int iBlocks : s_aBlocks)
+    {
+        std::string
+            Source = MakeSource(iBlocks),
+            Copy = Source;
+
+        iAllocations = GetAllocationCount();
+
+        CHECK(Parser.Parse(Source.c_str(), &Config, true, Source.size()) == iBlocks * 8); // Unknown keys count as parsed
+
+        iAllocations = GetAllocationCount() - iAllocations;
+
+        printf("%d blocks, %zu bytes: %zu allocations\n", iBlocks, Source.size(), iAllocations);
+
+        CHECK(iAllocations == 0);
+        CHECK(Source == Copy);
+        CHECK(Parser.GetErrorCount() == 0);
+
+        CHECK(Config.bActive == (iBlocks % 2 == 1));
+        CHECK(Config.iDelay == -iBlocks);
+        CHECK(Config.iCount == (unsigned int)iBlocks * 3);
+        CHECK(Config.iSmall == iBlocks % 1000);
+        CHECK(Config.fRadius == (float)iBlocks + 0.5f);
+        CHECK(Config.dScale == 0.25);
+        CHECK(strcmp(Config.szName, ("Block" + std::to_string(iBlocks)).c_str()) == 0);
+    }
+
+    // Single lines
+
+    iAllocations = GetAllocationCount();
+
+    CHECK(Parser.ParseValue(std::string_view("General"), std::string_view(" Delay =  42 "), &Config, true));
+    CHECK(Parser.ParseValue(std::string_view("other"), std::string_view("NAME = abc"), &Config, true));
+    CHECK(Parser.ParseValue(std::string_view(), std::string_view("Delay = 1"), &Config, true)); // No section, no link
+
+    CHECK(GetAllocationCount() - iAllocations == 0);
+    CHECK(Config.iDelay == 42);
+    CHECK(strcmp(Config.szName, "abc") == 0);
+}
+
+static void TestLines()
+{
+    StructParser<STestConfig>
+        Parser(g_TestSchema);
+
+    STestConfig
+        Config;
+
+    const char
+        *szSource =
+            "Delay = 1\n" // No section yet
+            "[General]\r\n"
+            "Delay = 2 = 3\n" // Value ends at the next '='
+            "Count\n"
+            "= 5\n"
+            "[]\n"
+            "Count = 6\n" // No section again
+            "[general]\n"
+            "COUNT = 7";
+
+    CHECK(Parser.Parse(szSource, &Config) == 4);
+    CHECK(Config.iDelay == 2);
+    CHECK(Config.iCount == 7);
+
+    Config = STestConfig();
+
+    CHECK(Parser.Parse(szSource, &Config, false) == 4); // Case sensitive
+    CHECK(Config.iDelay == 2);
+    CHECK(Config.iCount == 0);
+
+    CHECK(Parser.Parse("", &Config) == -1);
+}
+
+static void TestLists()
+{
+    StructParser<STestConfig>
+        Parser(g_TestSchema);
+
+    StructDocument<STestConfig>
+        Document;
+
+    STestConfig
+        Config,
+        DocumentConfig;
+
+    const char
+        *szFirst = "[Other]\nList = 500, 401 402",
+        *szSecond = "[Other]\nList = 500",
+        *szTooLong = "[Other]\nList = 1 2 3 4",
+        *szBad = "[Other]\nList = 1 x";
+
+    // Struct
+
+    CHECK(Parser.Parse(szFirst, &Config) == 1);
+    CHECK(Config.aList[0] == 500 && Config.aList[1] == 401 && Config.aList[2] == 402);
+
+    CHECK(Parser.Parse(szSecond, &Config) == 1);
+    CHECK(Config.aList[0] == 500 && Config.aList[1] == 0 && Config.aList[2] == 0);
+
+    // Document, applied to a struct with defaults that aren't 0
+
+    CHECK(Parser.Parse(szFirst, Document) == 1);
+    CHECK(Parser.Parse(szSecond, Document) == 1);
+
+    Document.Apply(&DocumentConfig);
+
+    CHECK(memcmp(Config.aList, DocumentConfig.aList, sizeof(Config.aList)) == 0);
+
+    // Failed lists don't change anything
+
+    CHECK(Parser.Parse(szTooLong, &Config) == 0);
+    CHECK(Parser.GetLastError() == ParseError::RANGE);
+    CHECK(Parser.Parse(szBad, &Config) == 0);
+    CHECK(Config.aList[0] == 500 && Config.aList[1] == 0 && Config.aList[2] == 0);
+}
+
+static constexpr const char
+    *UPDATE_FILE = "ParserTest.update.ini";
+
+static FILE* OpenFile(const char* szFileName, const char* szMode)
+{
+    FILE
+        *pFile;
+
+#if defined _WIN32
+    if (fopen_s(&pFile, szFileName, szMode))
+        pFile = nullptr;
+#else
+    pFile = fopen(szFileName, szMode);
+#endif
+
+    return pFile;
+}
+
+static void WriteText(const char* szFileName, const std::string& Text)
+{
+    FILE
+        *pFile = OpenFile(szFileName, "wb");
+
+    if (!pFile)
+        return;
+
+    fwrite(Text.data(), 1, Text.size(), pFile);
+    fclose(pFile);
+}
+
+static std::string ReadText(const char* szFileName)
+{
+    std::string
+        Text;
+
+    char
+        aBuffer[4096];
+
+    size_t
+        iRead;
+
+    FILE
+        *pFile = OpenFile(szFileName, "rb");
+
+    if (!pFile)
+        return Text;
+
+    while ((iRead = fread(aBuffer, 1, sizeof(aBuffer), pFile)) != 0)
+        Text.append(aBuffer, iRead);
+
+    fclose(pFile);
+
+    return Text;
+}
+
+// Replaces every occurrence of Find, used to turn the CRLF sources into LF ones.
+static std::string Replace(std::string Text, const std::string& Find, const std::string& With)
+{
+    for (size_t iPos = 0; (iPos = Text.find(Find, iPos)) != std::string::npos; iPos += With.size())
+        Text.replace(iPos, Find.size(), With);
+
+    return Text;
+}
+
+// Writes Text, runs Update() with Config and returns the file afterwards. The file's time is set back an hour first,
+// pbWritten tells if it changed.
+static std::string RunUpdate(const std::string& Text, const STestConfig& Config, int iExpectedChanges, bool* pbWritten = nullptr)
+{
+    StructParser<STestConfig>
+        Parser(g_TestSchema);
+
+    std::filesystem::file_time_type
+        tBefore;
+
+    std::error_code
+        Error;
+
+    WriteText(UPDATE_FILE, Text);
+
+    tBefore = std::filesystem::last_write_time(UPDATE_FILE, Error) - std::chrono::hours(1);
+    std::filesystem::last_write_time(UPDATE_FILE, tBefore, Error);
+
+    CHECK(Parser.Update(UPDATE_FILE, &Config) == iExpectedChanges);
+
+    if (pbWritten)
+        *pbWritten = std::filesystem::last_write_time(UPDATE_FILE, Error) != tBefore;
+
+    return ReadText(UPDATE_FILE);
+}
+
+// Parses Text into a default config.
+static STestConfig ParseText(const std::string& Text)
+{
+    StructParser<STestConfig>
+        Parser(g_TestSchema);
+
+    STestConfig
+        Config;
+
+    Parser.Parse(Text.c_str(), &Config, true, Text.size());
+
+    return Config;
+}
+
+static bool IsSame(const STestConfig& Config1, const STestConfig& Config2)
+{
+    return Config1.bActive == Config2.bActive && Config1.iDelay == Config2.iDelay && Config1.iCount == Config2.iCount &&
+        Config1.iSmall == Config2.iSmall && memcmp(&Config1.fRadius, &Config2.fRadius, sizeof(float)) == 0 &&
+        memcmp(&Config1.dScale, &Config2.dScale, sizeof(double)) == 0 && strcmp(Config1.szName, Config2.szName) == 0 &&
+        memcmp(Config1.aList, Config2.aList, sizeof(Config1.aList)) == 0;
+}
+
+static void TestUpdate()
+{
+    static const std::string
+        s_Full =
+            "; Comment\r\n"
+            "[General]\r\n"
+            "  Active   =   true  \r\n"
+            "Delay=5\r\n"
+            "Count = 3 ; not a comment, this fails to parse\r\n"
+            "\r\n"
+            "[Other]\r\n"
+            "Small = 1\r\n"
+            "Radius = 2.5\r\n"
+            "Scale = 0.25\r\n"
+            "Name = abc\r\n"
+            "List = 1, 2 3\r\n"
+            "Unknown = x\r\n",
+        s_MissingKey =
+            "[General]\r\n"
+            "Active = true\r\n"
+            "Delay = 5\r\n"
+            "\r\n"
+            "[Other]\r\n"
+            "Small = 1\r\n",
+        s_MissingSection =
+            "[General]\r\n"
+            "Active = true\r\n"
+            "Delay = 5\r\n"
+            "Count = 3";
+
+    STestConfig
+        Config;
+
+    std::string
+        Full,
+        Result;
+
+    bool
+        bWritten;
+
+    for (const char* szNewLine : { "\r\n", "\n" })
+    {
+        Full = Replace(s_Full, "\r\n", szNewLine);
+
+        // Up to date, except for Count which fails to parse and is written back
+
+        Config = ParseText(Full);
+        Config.iCount = 3;
+
+        Result = RunUpdate(Full, Config, 1, &bWritten);
+
+        CHECK(bWritten);
+        CHECK(Result == Replace(Full, "Count = 3 ; not a comment, this fails to parse", "Count = 3"));
+
+        Full = Result;
+
+        Result = RunUpdate(Full, Config, 0, &bWritten);
+
+        CHECK(!bWritten);
+        CHECK(Result == Full);
+
+        // Changed values are replaced in place, padding and everything around them stays
+
+        Config.bActive = false;
+        Config.iDelay = -12;
+        Config.aList[2] = 0;
+
+        Result = RunUpdate(Full, Config, 3, &bWritten);
+
+        CHECK(bWritten);
+        CHECK(Result == Replace(Replace(Replace(Full, "  Active   =   true  ", "  Active   =   false  "), "Delay=5", "Delay=-12"),
+            "List = 1, 2 3", "List = 1, 2"));
+        CHECK(IsSame(ParseText(Result), Config));
+
+        RunUpdate(Result, Config, 0, &bWritten);
+        CHECK(!bWritten);
+    }
+
+    // Missing key: added after the last line of its section, not after the empty line
+
+    Config = ParseText(s_Full);
+    Config.iCount = 3;
+
+    Result = RunUpdate(s_MissingKey, Config, 5);
+
+    CHECK(Result.rfind("[General]\r\nActive = true\r\nDelay = 5\r\nCount = 3\r\n\r\n[Other]\r\nSmall = 1\r\nRadius = 2.5\r\n", 0) == 0);
+    CHECK(IsSame(ParseText(Result), Config));
+
+    RunUpdate(Result, Config, 0, &bWritten);
+    CHECK(!bWritten);
+
+    // Missing section: added at the end with all of its keys, the last line gets its line end first
+
+    Result = RunUpdate(s_MissingSection, Config, 5);
+
+    CHECK(Result ==
+        "[General]\r\nActive = true\r\nDelay = 5\r\nCount = 3\r\n"
+        "\r\n"
+        "[Other]\r\nSmall = 1\r\nRadius = 2.5\r\nScale = 0.25\r\nName = abc\r\nList = 1, 2, 3\r\n");
+
+    RunUpdate(Result, Config, 0, &bWritten);
+    CHECK(!bWritten);
+
+    // Floats and lists read back as exactly the same value, also values with no short decimal form
+
+    Config.fRadius = 0.1f;
+    Config.dScale = 1.0 / 3.0;
+    Config.aList[0] = -2147483647 - 1;
+    Config.aList[1] = 0;
+    Config.aList[2] = 2147483647;
+
+    Result = RunUpdate(s_Full, Config, 4);
+
+    CHECK(IsSame(ParseText(Result), Config));
+
+    RunUpdate(Result, Config, 0, &bWritten);
+    CHECK(!bWritten);
+
+    Config.fRadius = 1e-30f;
+    Config.dScale = -1e300;
+    memset(Config.aList, 0, sizeof(Config.aList));
+
+    Result = RunUpdate(Result, Config, 3);
+
+    CHECK(IsSame(ParseText(Result), Config));
+
+    RunUpdate(Result, Config, 0, &bWritten);
+    CHECK(!bWritten);
+
+    // No file yet: everything is added
+
+    remove(UPDATE_FILE);
+
+    {
+        StructParser<STestConfig>
+            Parser(g_TestSchema);
+
+        CHECK(Parser.Update(UPDATE_FILE, &Config) == 8);
+        CHECK(IsSame(ParseText(ReadText(UPDATE_FILE)), Config));
+    }
+
+    remove(UPDATE_FILE);
+}
+
+// Feeds Source split at the given offsets, then checks the result against Parse().
+static void CheckStream(const std::string& Source, std::vector<size_t> vSplits)
+{
+    StructParser<STestConfig>
+        Parser(g_TestSchema);
+
+    STestConfig
+        Config,
+        Expected;
+
+    StructStream<STestConfig>
+        Stream(Parser, &Config);
+
+    int
+        iExpected,
+        iExpectedErrors;
+
+    size_t
+        iStart = 0;
+
+    iExpected = Parser.Parse(Source.c_str(), &Expected, true, Source.size());
+    iExpectedErrors = Parser.GetErrorCount();
+
+    vSplits.push_back(Source.size());
+    std::sort(vSplits.begin(), vSplits.end());
+
+    for (size_t iSplit : vSplits)
+    {
+        Stream.Feed(Source.data() + iStart, iSplit - iStart);
+        iStart = iSplit;
+    }
+
+    CHECK(Stream.Finish() == iExpected);
+    CHECK(Parser.GetErrorCount() == iExpectedErrors);
+    CHECK(IsSame(Config, Expected));
+}
+
+static void TestStream()
+{
+    Random
+        Rand;
+
+    std::string
+        Source = MakeSource(50) +
+            "[Other]\r\n"
+            "Small = 100000\r\n" // RANGE
+            "Radius = x\r\n" // SYNTAX
+            "[General]\r\n"
+            "Count = 8"; // No line end
+
+    std::vector<size_t>
+        vSplits;
+
+    StructParser<STestConfig>
+        Parser(g_TestSchema);
+
+    STestConfig
+        Config;
+
+    // The errors are compared as well, so make sure there are some
+
+    CHECK(Parser.Parse(Source.c_str(), &Config, true, Source.size()) == 50 * 8 + 1);
+    CHECK(Parser.GetErrorCount() == 2);
+
+    // Every single byte
+
+    for (size_t i = 1; i < Source.size(); ++i)
+        vSplits.push_back(i);
+
+    CheckStream(Source, vSplits);
+
+    // Between every CR and LF, and inside every section header
+
+    vSplits.clear();
+
+    for (size_t i = 0; i < Source.size(); ++i)
+    {
+        if (Source[i] == '\r')
+            vSplits.push_back(i + 1);
+        else if (Source[i] == '[')
+            vSplits.push_back(i + 1 + (size_t)Rand.Int(0, 4));
+    }
+
+    CheckStream(Source, vSplits);
+
+    // Random chunk sizes, from single bytes to several lines
+
+    for (int iRun = 0; iRun < 200; ++iRun)
+    {
+        vSplits.clear();
+
+        for (size_t i = (size_t)Rand.Int(1, 64); i < Source.size(); i += (size_t)Rand.Int(1, iRun % 2 ? 8 : 300))
+            vSplits.push_back(i);
+
+        CheckStream(Source, vSplits);
+    }
+
+    // Lines up to LINE_SIZE are parsed, longer ones are LENGTH errors and the lines after them are still parsed.
+    // Checked with the line in one chunk and split.
+
+    for (size_t iChunk : { (size_t)1, (size_t)7, (size_t)512, (size_t)4096 })
+    {
+        constexpr size_t
+            LINE_SIZE = StructStream<STestConfig>::LINE_SIZE;
+
+        StructStream<STestConfig>
+            Stream(Parser, &Config);
+
+        std::string
+            MaxLine = "Delay = 7",
+            LongLine = "Delay = 8";
+
+        Config = STestConfig();
+
+        MaxLine.resize(LINE_SIZE, ' ');
+        LongLine.resize(LINE_SIZE + 1, ' ');
+
+        Source = "[General]\n" + LongLine + "\nCount = 5\n" + MaxLine + "\r\n";
+
+        for (size_t i = 0; i < Source.size(); i += iChunk)
+            Stream.Feed(Source.data() + i, std::min(iChunk, Source.size() - i));
+
+        CHECK(Stream.Finish() == 2);
+        CHECK(Parser.GetErrorCount() == 1);
+        CHECK(Parser.GetLastError() == ParseError::LENGTH);
+        CHECK(Config.iDelay == 7);
+        CHECK(Config.iCount == 5);
+    }
+}
+
+int main()
+{
+    TestNoAllocations();
+    TestLines();
+    TestLists();
+    TestUpdate();
+    TestStream();
+
+    printf("StructParser: %s\n", GetFailureCount() ? "FAILED" : "passed");
+
+    return GetFailureCount() ? 1 : 0;
+}
+
+// ---------------------------------------------------------
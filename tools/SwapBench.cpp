@@ -0,0 +1,101 @@
+// ---------------------------------------------------------
+/*
+
+    SwapBench
+
+    Load benchmark for SwapEngine: runs it against a
+    SimWorld with 110 (the default vehicle pool) to 10000
+    moving vehicles and prints the cost of a tick and how
+    many swaps happened per second of game time.
+
+    Only the engine's Process() is timed, not the world's
+    Step(). The world is seeded, so the swap counts are the
+    same on every run and platform.
+
+    Usage: SwapBench [ticks]
+
+*/
+// ---------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../SwapEngine.h"
+#include "../SimWorld.h"
+#include "Bench.h"
+
+static constexpr unsigned int
+    TICK_MS = 20; // 50 fps
+
+static constexpr float
+    AREA_SIZE = 1500.0f,
+    MAX_SPEED = 1.5f,
+    DRIVER_RATIO = 0.5f;
+
+int main(int argc, char* argv[])
+{
+    static const int
+        s_aVehicleCounts[] = { 110, 500, 1000, 2000, 5000, 10000 };
+
+    int
+        iTicks = argc > 1 ? atoi(argv[1]) : 5000;
+
+    if (iTicks <= 0)
+        iTicks = 1;
+
+    printf("%d ticks of %u ms per vehicle count, predictive swaps on, no swap delay\n\n", iTicks, TICK_MS);
+    printf("%8s %10s %10s %8s %10s\n", "vehicles", "us/tick", "max us", "swaps", "swaps/s");
+
+    for (int iCount : s_aVehicleCounts)
+    {
+        SimWorld
+            World(iCount + 1, 2 * iCount + 2);
+
+        SwapEngine<SimWorld>
+            Engine(World);
+
+        SConfig
+            Config;
+
+        Stopwatch
+            Timer;
+
+        double
+            dTime,
+            dTotal = 0.0,
+            dMax = 0.0;
+
+        World.SetListeners([&](int i) { Engine.OnVehicleCreated(i); }, [&](int i) { Engine.OnVehicleDestroyed(i); });
+        World.SetPedListeners([&](int i) { Engine.OnPedCreated(i); }, [&](int i) { Engine.OnPedDestroyed(i); });
+
+        Config.bPredictiveSwap = true;
+        Config.iSwapDelay = 0;
+        Engine.SetConfig(Config);
+
+        World.Populate(iCount, AREA_SIZE, MAX_SPEED, DRIVER_RATIO);
+        Engine.Init();
+
+        for (int iTick = 0; iTick < iTicks; ++iTick)
+        {
+            World.Step(1.0f, TICK_MS);
+
+            Timer.Restart();
+            Engine.Process();
+            dTime = Timer.GetMicroseconds();
+
+            dTotal += dTime;
+
+            if (dTime > dMax)
+                dMax = dTime;
+        }
+
+        Engine.Shutdown();
+
+        printf("%8d %10.2f %10.2f %8u %10.2f\n", iCount, dTotal / iTicks, dMax, Engine.GetSwapCount(),
+            (double)Engine.GetSwapCount() * 1000.0 / ((double)iTicks * TICK_MS));
+    }
+
+    return 0;
+}
+
+// ---------------------------------------------------------
@@ -0,0 +1,142 @@
+// ---------------------------------------------------------
+/*
+
+    SwapEngineTest
+
+    Checks that SwapEngine releases the vehicles its physics
+    budget promoted on every tick that ends before the
+    player's surroundings are looked at: the plugin turned
+    off, the player not playing, on a mission, in a mini
+    game, a passenger or on foot without targets. Each case
+    starts from a SimWorld where driven vehicles around the
+    player's car were promoted.
+
+    Also checks that the swap delay, which only lasts a few
+    ticks, keeps them promoted.
+
+    The exit code is 1 if anything fails.
+
+*/
+// ---------------------------------------------------------
+
+#include <stdio.h>
+#include <functional>
+#include <vector>
+
+#include "../SwapEngine.h"
+#include "../SimWorld.h"
+#include "Bench.h"
+
+static constexpr int
+    VEHICLE_COUNT = 6;
+
+static constexpr unsigned int
+    TICK_MS = 20;
+
+static int CountPromoted(SimWorld& World, const std::vector<int>& vVehicles)
+{
+    int
+        iCount = 0;
+
+    for (int iVehicle : vVehicles)
+        if (World.IsVehiclePromoted(iVehicle))
+            ++iCount;
+
+    return iCount;
+}
+
+// fnLeave changes the world or the config after the vehicles were promoted, then one more tick is run.
+// Returns the amount of vehicles that are still promoted after it.
+static int RunCase(const std::function<void(SimWorld&, SConfig&, int iPlayerVehicle)>& fnLeave)
+{
+    SimWorld
+        World(VEHICLE_COUNT + 1, 2 * VEHICLE_COUNT + 2);
+
+    SwapEngine<SimWorld>
+        Engine(World);
+
+    SConfig
+        Config;
+
+    std::vector<int>
+        vVehicles;
+
+    int
+        iPlayerVehicle;
+
+    World.SetListeners([&](int i) { Engine.OnVehicleCreated(i); }, [&](int i) { Engine.OnVehicleDestroyed(i); });
+    World.SetPedListeners([&](int i) { Engine.OnPedCreated(i); }, [&](int i) { Engine.OnPedDestroyed(i); });
+
+    Config.iSwapDelay = 0;
+    Engine.SetConfig(Config);
+
+    // Parked cars with drivers around the player, far enough apart to never touch
+
+    iPlayerVehicle = World.SpawnPlayer(SVector3(0.0f, 0.0f, 0.0f), SVector3());
+
+    for (int i = 0; i < VEHICLE_COUNT; ++i)
+        vVehicles.push_back(World.SpawnVehicle(SVector3(-25.0f + 10.0f * (float)i, 15.0f, 0.0f), SVector3(), true));
+
+    Engine.Init();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        World.Step(1.0f, TICK_MS);
+        Engine.Process();
+    }
+
+    CHECK(CountPromoted(World, vVehicles) == VEHICLE_COUNT);
+
+    fnLeave(World, Config, iPlayerVehicle);
+    Engine.SetConfig(Config);
+
+    World.Step(1.0f, TICK_MS);
+    Engine.Process();
+
+    return CountPromoted(World, vVehicles);
+}
+
+int main()
+{
+    CHECK(RunCase([](SimWorld&, SConfig& Config, int) { Config.bActive = false; }) == 0);
+    CHECK(RunCase([](SimWorld& World, SConfig&, int) { World.SetPlaying(false); }) == 0);
+    CHECK(RunCase([](SimWorld& World, SConfig&, int) { World.SetOnMission(true); }) == 0);
+    CHECK(RunCase([](SimWorld& World, SConfig&, int) { World.SetMiniGame(true); }) == 0);
+
+    // Someone else is driving the player's car
+
+    CHECK(RunCase([](SimWorld& World, SConfig&, int iPlayerVehicle)
+    {
+        int
+            iDriver = World.SpawnPed(SVector3(), SVector3());
+
+        // The player stays in the car as a passenger
+
+        World.WarpPedIntoVehicle(iDriver, iPlayerVehicle);
+    }) == 0);
+
+    // On foot, nothing to swap to
+
+    CHECK(RunCase([](SimWorld& World, SConfig&, int)
+    {
+        World.WarpPedOutOfVehicle(World.GetPlayerPed());
+    }) == 0);
+
+    // Allowed on missions, so nothing changes
+
+    CHECK(RunCase([](SimWorld& World, SConfig& Config, int)
+    {
+        Config.bActiveOnMission = true;
+        World.SetOnMission(true);
+    }) == VEHICLE_COUNT);
+
+    // The swap delay only lasts a few ticks, the vehicles stay promoted during it
+
+    CHECK(RunCase([](SimWorld&, SConfig& Config, int) { Config.iSwapDelay = 1000000; }) == VEHICLE_COUNT);
+
+    printf("SwapEngine: %s\n", GetFailureCount() ? "FAILED" : "passed");
+
+    return GetFailureCount() ? 1 : 0;
+}
+
+// ---------------------------------------------------------
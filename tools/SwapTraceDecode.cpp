@@ -0,0 +1,217 @@
+// ---------------------------------------------------------
+/*
+
+    SwapTraceDecode
+
+    Prints a summary of a swap trace written by a DNC_TRACE
+    build (DoNotCrash.swaps.trace): swap rate, swaps per
+    kind (vehicle/ped to vehicle/ped), time between swaps,
+    time spent in the warp commands and how much speed the
+    vehicles lost in them.
+
+    Usage: SwapTraceDecode <trace file> [-v]
+    -v also prints every record.
+
+    Standalone, builds with any C++17 compiler:
+    cl /std:c++17 /O2 SwapTraceDecode.cpp
+    g++ -std=c++17 -O2 SwapTraceDecode.cpp -o SwapTraceDecode
+
+*/
+// ---------------------------------------------------------
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "../SwapTrace.h"
+
+using namespace SwapTrace;
+
+static const char
+    *s_aTypeNames[] = { "vehicle", "ped", "object" }; // Indexed by EntityType::
+
+static constexpr unsigned int
+    TYPE_COUNT = sizeof(s_aTypeNames) / sizeof(s_aTypeNames[0]);
+
+static const char* GetTypeName(unsigned int iType)
+{
+    return iType < TYPE_COUNT ? s_aTypeNames[iType] : "?";
+}
+
+// Nearest rank, vValues must be sorted.
+static double Percentile(const std::vector<double>& vValues, double dFraction)
+{
+    size_t
+        iIndex;
+
+    if (vValues.empty())
+        return 0.0;
+
+    iIndex = (size_t)ceil(dFraction * (double)vValues.size());
+
+    return vValues[iIndex > 0 ? iIndex - 1 : 0];
+}
+
+static void PrintDistribution(const char* szName, std::vector<double>& vValues, const char* szUnit)
+{
+    double
+        dSum = 0.0;
+
+    if (vValues.empty())
+    {
+        printf("%-16s -\n", szName);
+        return;
+    }
+
+    std::sort(vValues.begin(), vValues.end());
+
+    for (double dValue : vValues)
+        dSum += dValue;
+
+    printf("%-16s mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f %s\n", szName, dSum / (double)vValues.size(),
+        Percentile(vValues, 0.5), Percentile(vValues, 0.9), Percentile(vValues, 0.99), vValues.back(), szUnit);
+}
+
+static float Speed(const SVector3& vecVelocity)
+{
+    return sqrtf(vecVelocity.MagnitudeSqr());
+}
+
+int main(int argc, char* argv[])
+{
+    FILE
+        *pFile;
+
+    SHeader
+        Header;
+
+    SSwapRecord
+        Record;
+
+    std::vector<SSwapRecord>
+        vRecords;
+
+    std::vector<double>
+        vWarpTimes,
+        vIntervals,
+        vSpeedKept;
+
+    unsigned long long
+        iDropped = 0;
+
+    size_t
+        iWithDriver = 0,
+        aKindCounts[TYPE_COUNT][TYPE_COUNT] = {};
+
+    double
+        dDuration;
+
+    bool
+        bVerbose = argc > 2 && strcmp(argv[2], "-v") == 0;
+
+    if (argc < 2)
+    {
+        printf("Usage: %s <trace file> [-v]\n", argv[0]);
+        return 1;
+    }
+
+#if defined _WIN32
+    if (fopen_s(&pFile, argv[1], "rb"))
+        pFile = nullptr;
+#else
+    pFile = fopen(argv[1], "rb");
+#endif
+
+    if (!pFile)
+    {
+        printf("Can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    if (fread(&Header, sizeof(Header), 1, pFile) != 1 || Header.iMagic != MAGIC)
+    {
+        printf("%s is not a swap trace\n", argv[1]);
+        fclose(pFile);
+        return 1;
+    }
+
+    if (Header.iVersion != VERSION || Header.iRecordSize != sizeof(SSwapRecord))
+    {
+        printf("%s has version %u (record size %u), expected version %u (record size %u)\n", argv[1],
+            Header.iVersion, Header.iRecordSize, VERSION, (unsigned int)sizeof(SSwapRecord));
+        fclose(pFile);
+        return 1;
+    }
+
+    // A partially written last record (ie. the game crashed) is ignored
+
+    while (fread(&Record, sizeof(Record), 1, pFile) == 1)
+        vRecords.push_back(Record);
+
+    fclose(pFile);
+
+    printf("%s: %zu swaps\n", argv[1], vRecords.size());
+
+    if (vRecords.empty())
+        return 0;
+
+    // Collect
+
+    for (size_t i = 0; i < vRecords.size(); ++i)
+    {
+        const SSwapRecord
+            &Swap = vRecords[i];
+
+        vWarpTimes.push_back((double)Swap.iWarpTime / 1000.0);
+
+        if (Swap.iPlayerType < TYPE_COUNT && Swap.iTargetType < TYPE_COUNT)
+            ++aKindCounts[Swap.iPlayerType][Swap.iTargetType];
+
+        if (Swap.iTargetType == 0 && Speed(Swap.vecTargetBefore) > 0.01f) // Speed the player keeps in the new vehicle (type 0), before it's restored
+            vSpeedKept.push_back(100.0 * (double)Speed(Swap.vecTargetAfter) / (double)Speed(Swap.vecTargetBefore));
+
+        if (Swap.bTargetDriver)
+            ++iWithDriver;
+
+        if (i > 0)
+        {
+            vIntervals.push_back((double)(Swap.iTime - vRecords[i - 1].iTime) / 1000.0);
+            iDropped += Swap.iSequence - vRecords[i - 1].iSequence - 1;
+        }
+
+        if (bVerbose)
+        {
+            printf("#%u %.3f s  %s %d (model %d) -> %s %d (model %d)%s  warp %.1f us  speed %.3f -> %.3f\n", Swap.iSequence,
+                (double)(Swap.iTime - vRecords[0].iTime) / 1000000.0, GetTypeName(Swap.iPlayerType), Swap.iPlayer, Swap.iPlayerModel,
+                GetTypeName(Swap.iTargetType), Swap.iTarget, Swap.iTargetModel, Swap.bTargetDriver ? " driven" : "",
+                (double)Swap.iWarpTime / 1000.0, Speed(Swap.vecTargetBefore), Speed(Swap.vecTargetAfter));
+        }
+    }
+
+    // Summary
+
+    dDuration = (double)(vRecords.back().iTime - vRecords.front().iTime) / 1000000.0;
+
+    printf("duration         %.1f s\n", dDuration);
+
+    if (dDuration > 0.0)
+        printf("swap rate        %.2f per minute\n", (double)(vRecords.size() - 1) * 60.0 / dDuration);
+
+    printf("dropped          %llu\n", iDropped);
+    printf("target driven    %zu (%.1f%%)\n", iWithDriver, 100.0 * (double)iWithDriver / (double)vRecords.size());
+
+    for (unsigned int iFrom = 0; iFrom < TYPE_COUNT; ++iFrom)
+        for (unsigned int iTo = 0; iTo < TYPE_COUNT; ++iTo)
+            if (aKindCounts[iFrom][iTo])
+                printf("%-7s -> %-7s %zu\n", s_aTypeNames[iFrom], s_aTypeNames[iTo], aKindCounts[iFrom][iTo]);
+
+    PrintDistribution("warp time", vWarpTimes, "us");
+    PrintDistribution("between swaps", vIntervals, "ms");
+    PrintDistribution("speed kept", vSpeedKept, "%");
+
+    return 0;
+}
+
+// ---------------------------------------------------------